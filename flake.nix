@@ -80,7 +80,10 @@
           in
           deps ++ nil-packages;
 
-        devInputs = [ pkgs.clang_17 ];
+        devInputs = [
+          pkgs.clang_17
+          pkgs.gbenchmark
+        ];
 
         makePackage =
           {
@@ -0,0 +1,558 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) Nil Foundation and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------//
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <assigner.hpp>
+#include <nil/blueprint/blueprint/plonk/assignment.hpp>
+
+#include <evmc.hpp>
+#include <instructions_opcodes.hpp>
+#include <vm_host.hpp>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+using BlueprintFieldType = typename nil::crypto3::algebra::curves::pallas::base_field_type;
+using ArithmetizationType = nil::crypto3::zk::snark::plonk_constraint_system<BlueprintFieldType>;
+using assignment_type = nil::blueprint::assignment<ArithmetizationType>;
+using assigner_type = nil::evm_assigner::assigner<BlueprintFieldType>;
+using word_type = nil::evm_assigner::zkevm_word<BlueprintFieldType>;
+
+/// Upper bound for interpreter and sorting benchmarks.
+constexpr int64_t max_ops = 10'000'000;
+/// Upper bound for benchmarks filling assignment tables.
+/// Every RW row takes 60 field elements, so 1e7 rows does not fit into memory of usual machine.
+constexpr int64_t max_rows = 1'000'000;
+
+constexpr evmc_revision bench_rev = EVMC_LATEST_STABLE_REVISION;
+
+std::vector<assignment_type> make_assignments()
+{
+    const std::size_t WitnessColumns = 65;
+    const std::size_t PublicInputColumns = 1;
+    const std::size_t ConstantColumns = 5;
+    const std::size_t SelectorColumns = 30;
+
+    nil::crypto3::zk::snark::plonk_table_description<BlueprintFieldType> desc(
+        WitnessColumns, PublicInputColumns, ConstantColumns, SelectorColumns);
+
+    std::vector<assignment_type> assignments;
+    assignments.emplace_back(desc);
+    assignments.emplace_back(desc);
+    return assignments;
+}
+
+evmc_message make_message()
+{
+    evmc_message msg{};
+    msg.kind = EVMC_CALL;
+    msg.gas = std::numeric_limits<int64_t>::max() / 2;
+    msg.recipient = {{1, 1, 2}};
+    msg.sender = {{0, 1, 2}};
+    msg.code_address = {{2, 1, 2}};
+    return msg;
+}
+
+evmc_tx_context make_tx_context()
+{
+    evmc_tx_context tx_context{};
+    tx_context.block_number = 42;
+    tx_context.block_timestamp = 66;
+    tx_context.block_gas_limit = std::numeric_limits<int64_t>::max();
+    return tx_context;
+}
+
+/// Builds the code which executes the stack neutral body in the loop
+/// until approximately num_ops instructions are executed.
+///
+///     PUSH4 counter
+///     JUMPDEST
+///     body
+///     PUSH1 1 SWAP1 SUB DUP1 PUSH2 5 JUMPI
+///     POP STOP
+std::vector<uint8_t> make_loop_code(const std::vector<uint8_t>& body, size_t body_ops, int64_t num_ops)
+{
+    constexpr size_t loop_ops = 7;
+    const auto iterations = static_cast<uint32_t>(
+        std::max<int64_t>(1, num_ops / static_cast<int64_t>(body_ops + loop_ops)));
+
+    std::vector<uint8_t> code = {evmone::OP_PUSH4,
+        static_cast<uint8_t>(iterations >> 24), static_cast<uint8_t>(iterations >> 16),
+        static_cast<uint8_t>(iterations >> 8), static_cast<uint8_t>(iterations),
+        evmone::OP_JUMPDEST};
+    code.insert(code.end(), body.begin(), body.end());
+    code.insert(code.end(), {evmone::OP_PUSH1, 1, evmone::OP_SWAP1, evmone::OP_SUB, evmone::OP_DUP1,
+        evmone::OP_PUSH2, 0, 5, evmone::OP_JUMPI, evmone::OP_POP, evmone::OP_STOP});
+    return code;
+}
+
+/// Stack neutral loop bodies for opcode families and number of instructions in them.
+struct loop_body
+{
+    std::vector<uint8_t> code;
+    size_t num_ops;
+};
+
+const loop_body arithmetic_body = {{evmone::OP_PUSH1, 7, evmone::OP_PUSH1, 3, evmone::OP_ADD,
+    evmone::OP_PUSH1, 5, evmone::OP_MUL, evmone::OP_PUSH1, 2, evmone::OP_SUB, evmone::OP_PUSH1, 3,
+    evmone::OP_DIV, evmone::OP_PUSH1, 11, evmone::OP_MOD, evmone::OP_POP}, 12};
+
+const loop_body bitwise_body = {{evmone::OP_PUSH1, 0xf0, evmone::OP_PUSH1, 0x0f, evmone::OP_AND,
+    evmone::OP_PUSH1, 1, evmone::OP_OR, evmone::OP_PUSH1, 3, evmone::OP_XOR, evmone::OP_NOT,
+    evmone::OP_PUSH1, 2, evmone::OP_SHL, evmone::OP_ISZERO, evmone::OP_POP}, 12};
+
+const loop_body stack_body = {{evmone::OP_PUSH1, 1, evmone::OP_PUSH1, 2, evmone::OP_DUP2,
+    evmone::OP_DUP2, evmone::OP_SWAP1, evmone::OP_SWAP2, evmone::OP_POP, evmone::OP_POP,
+    evmone::OP_POP, evmone::OP_POP}, 10};
+
+const loop_body push_body = {{evmone::OP_PUSH32,
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
+    0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20,
+    evmone::OP_POP}, 2};
+
+/// Pattern of bigint libraries: operands are duplicated, added and the carry is computed by comparison.
+const loop_body mixed_body = {{evmone::OP_PUSH1, 0xff, evmone::OP_PUSH1, 1, evmone::OP_DUP2,
+    evmone::OP_DUP2, evmone::OP_ADD, evmone::OP_DUP1, evmone::OP_DUP4, evmone::OP_GT, evmone::OP_SWAP3,
+    evmone::OP_XOR, evmone::OP_MUL, evmone::OP_EQ, evmone::OP_ISZERO, evmone::OP_POP}, 14};
+
+const loop_body memory_body = {{evmone::OP_PUSH1, 42, evmone::OP_PUSH1, 0, evmone::OP_MSTORE,
+    evmone::OP_PUSH1, 0, evmone::OP_MLOAD, evmone::OP_POP}, 6};
+
+/// Every iteration stores a word 1 KB after the end of memory, so the memory grows all the time.
+const loop_body memory_expansion_body = {{evmone::OP_PUSH1, 42, evmone::OP_PUSH2, 0x04, 0x00,
+    evmone::OP_MSIZE, evmone::OP_ADD, evmone::OP_MSTORE}, 5};
+
+const loop_body storage_body = {{evmone::OP_PUSH1, 42, evmone::OP_PUSH1, 1, evmone::OP_SSTORE,
+    evmone::OP_PUSH1, 1, evmone::OP_SLOAD, evmone::OP_POP}, 6};
+
+/// Empty body, only the loop control flow with JUMPI is executed.
+const loop_body jump_body = {{}, 0};
+
+/// Random RW operations with roughly the mix of real transactions:
+/// mostly stack, some memory and a few storage accesses.
+nil::evm_assigner::rw_trace_buffer<BlueprintFieldType> make_rw_trace(size_t size)
+{
+    std::mt19937_64 rng{size};
+    nil::evm_assigner::rw_trace_buffer<BlueprintFieldType> trace;
+    trace.reserve(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        const auto kind = rng() % 16;
+        const bool is_write = (rng() & 1) != 0;
+        if (kind < 11)
+        {
+            trace.push_stack(0, static_cast<uint16_t>(rng() % 1024), i, is_write, word_type(uint64_t{rng()}));
+        }
+        else if (kind < 15)
+        {
+            trace.push_memory(0, word_type(uint64_t{rng() % (1 << 20)}), i, is_write, word_type(uint64_t{rng() & 0xff}));
+        }
+        else
+        {
+            const word_type address(uint64_t{rng() % 16});
+            const word_type key(uint64_t{rng() % 256});
+            const word_type value(uint64_t{rng()});
+            trace.push_back(nil::evm_assigner::storage_operation<BlueprintFieldType>(
+                0, address, key, i, is_write, value, value));
+        }
+    }
+    return trace;
+}
+
+std::vector<uint8_t> make_random_code(size_t size)
+{
+    std::mt19937_64 rng{size};
+    std::vector<uint8_t> code(size);
+    for (auto& byte : code)
+        byte = static_cast<uint8_t>(rng());
+    return code;
+}
+
+void evaluate(benchmark::State& state, const loop_body& body)
+{
+    const auto code = make_loop_code(body.code, body.num_ops, state.range(0));
+    const auto msg = make_message();
+    auto tx_context = make_tx_context();
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto assignments = make_assignments();
+        auto assigner_ptr = std::make_shared<assigner_type>(assignments);
+        VMHost<BlueprintFieldType> host{tx_context, assigner_ptr};
+        state.ResumeTiming();
+
+        auto result = nil::evm_assigner::evaluate<BlueprintFieldType>(&host.get_interface(),
+            host.to_context(), bench_rev, &msg, code.data(), code.size(), assigner_ptr);
+        benchmark::DoNotOptimize(result.gas_left);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+using dispatch_fn = int64_t (*)(const evmone::baseline::CostTable&,
+    evmone::ExecutionState<BlueprintFieldType>&, int64_t, const uint8_t*) noexcept;
+
+void run_dispatch(benchmark::State& state, const loop_body& body, dispatch_fn dispatch_loop)
+{
+    const auto code = make_loop_code(body.code, body.num_ops, state.range(0));
+    const auto msg = make_message();
+    auto tx_context = make_tx_context();
+    auto assignments = make_assignments();
+    auto assigner_ptr = std::make_shared<assigner_type>(assignments);
+    VMHost<BlueprintFieldType> host{tx_context, assigner_ptr};
+
+    const evmone::bytes_view container{code.data(), code.size()};
+    // Code is pre-decoded for dispatch_decoded, other loops do not use the decoded instructions.
+    const auto code_analysis = evmone::baseline::analyze(bench_rev, container, true);
+    const auto& cost_table =
+        evmone::baseline::get_baseline_cost_table(bench_rev, code_analysis.eof_header.version);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto execution_state = std::make_unique<evmone::ExecutionState<BlueprintFieldType>>(msg,
+            bench_rev, host.get_interface(), host.to_context(), container, evmone::bytes_view{}, 0,
+            assigner_ptr);
+        execution_state->analysis.baseline = &code_analysis;
+        state.ResumeTiming();
+
+        const auto gas = dispatch_loop(
+            cost_table, *execution_state, msg.gas, code_analysis.executable_code.data());
+        benchmark::DoNotOptimize(gas);
+
+        state.PauseTiming();
+        execution_state.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void dispatch(benchmark::State& state, const loop_body& body)
+{
+    run_dispatch(state, body, &evmone::baseline::dispatch<true, evmone::any_revision, BlueprintFieldType>);
+}
+
+/// Loop instantiated for the revision, bench_rev is the latest stable one.
+void dispatch_specialized(benchmark::State& state, const loop_body& body)
+{
+    static_assert(bench_rev == evmone::baseline::specialized_revision);
+    run_dispatch(state, body, &evmone::baseline::dispatch<true, bench_rev, BlueprintFieldType>);
+}
+
+/// Interpreter loops are compared on the same code regardless of the build option.
+void dispatch_switch(benchmark::State& state, const loop_body& body)
+{
+    run_dispatch(state, body, &evmone::baseline::dispatch_switch<true, evmone::any_revision, BlueprintFieldType>);
+}
+
+void dispatch_blocks(benchmark::State& state, const loop_body& body)
+{
+    run_dispatch(state, body, &evmone::baseline::dispatch_blocks<true, evmone::any_revision, BlueprintFieldType>);
+}
+
+void dispatch_decoded(benchmark::State& state, const loop_body& body)
+{
+    run_dispatch(state, body, &evmone::baseline::dispatch_decoded<true, evmone::any_revision, BlueprintFieldType>);
+}
+
+void dispatch_cached_top(benchmark::State& state, const loop_body& body)
+{
+    run_dispatch(state, body, &evmone::baseline::dispatch_cached_top<true, evmone::any_revision, BlueprintFieldType>);
+}
+
+#ifdef EVM_ASSIGNER_HAS_COMPUTED_GOTO
+void dispatch_computed_goto(benchmark::State& state, const loop_body& body)
+{
+    run_dispatch(state, body, &evmone::baseline::dispatch_computed_goto<true, evmone::any_revision, BlueprintFieldType>);
+}
+#endif
+
+void analyze(benchmark::State& state, bool decode, bool blocks)
+{
+    const auto code = make_random_code(static_cast<size_t>(state.range(0)));
+    const evmone::bytes_view container{code.data(), code.size()};
+    for (auto _ : state)
+    {
+        auto code_analysis = evmone::baseline::analyze(bench_rev, container, decode, blocks);
+        benchmark::DoNotOptimize(code_analysis.executable_code.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+/// Memory of the reused execution state grows to range(0) bytes and is cleared.
+void memory_grow_clear(benchmark::State& state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    evmone::Memory memory;
+    for (auto _ : state)
+    {
+        for (size_t new_size = 4096; new_size <= size; new_size *= 2)
+        {
+            if (!memory.grow(new_size))
+            {
+                state.SkipWithError("memory is not mapped");
+                return;
+            }
+            memory[new_size - 1] = 1;
+        }
+        benchmark::DoNotOptimize(memory.data());
+        memory.clear();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+/// Addresses of the accounts in random order, so lookups are not served by neighbouring memory.
+std::vector<evmc::address> make_shuffled_addresses(size_t size)
+{
+    std::vector<evmc::address> addresses;
+    addresses.reserve(size);
+    for (uint64_t i = 0; i < size; ++i)
+        addresses.emplace_back(i + 1);
+    std::shuffle(addresses.begin(), addresses.end(), std::mt19937_64{size});
+    return addresses;
+}
+
+void host_get_balance(benchmark::State& state)
+{
+    const auto addresses = make_shuffled_addresses(static_cast<size_t>(state.range(0)));
+    evmc::accounts accounts;
+    accounts.reserve(addresses.size());
+    for (const auto& addr : addresses)
+        accounts[addr].balance = evmc::uint256be{1};
+    auto tx_context = make_tx_context();
+    auto assignments = make_assignments();
+    auto assigner_ptr = std::make_shared<assigner_type>(assignments);
+    VMHost<BlueprintFieldType> host{tx_context, accounts, assigner_ptr};
+
+    for (auto _ : state)
+    {
+        for (const auto& addr : addresses)
+            benchmark::DoNotOptimize(host.get_balance(addr));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// SLOAD and SSTORE of the existing slots of one account.
+void host_storage(benchmark::State& state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    std::vector<evmc::bytes32> keys;
+    keys.reserve(size);
+    for (uint64_t i = 0; i < size; ++i)
+        keys.emplace_back(i);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64{size});
+
+    const evmc::address addr{1};
+    evmc::accounts accounts;
+    auto& storage = accounts[addr].storage;
+    for (const auto& key : keys)
+        storage[key] = key;
+    auto tx_context = make_tx_context();
+    auto assignments = make_assignments();
+    auto assigner_ptr = std::make_shared<assigner_type>(assignments);
+    VMHost<BlueprintFieldType> host{tx_context, accounts, assigner_ptr};
+
+    for (auto _ : state)
+    {
+        for (const auto& key : keys)
+            benchmark::DoNotOptimize(host.set_storage(addr, key, host.get_storage(addr, key)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void rw_sort(benchmark::State& state)
+{
+    const auto trace = make_rw_trace(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        const auto order = nil::evm_assigner::sort_rw_operations(trace);
+        benchmark::DoNotOptimize(order.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+std::vector<word_type> make_random_words(size_t size)
+{
+    std::mt19937_64 rng{size};
+    std::vector<word_type> words;
+    words.reserve(size);
+    for (size_t i = 0; i < size; ++i)
+        words.emplace_back(intx::uint256{rng(), rng(), rng(), rng()});
+    return words;
+}
+
+void word_chunks_16(benchmark::State& state)
+{
+    const auto words = make_random_words(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        uint64_t sum = 0;
+        for (const auto& word : words)
+            for (const auto chunk : word.to_chunks_16())
+                sum += chunk;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Previous way of splitting the word: masking and shifting of the multiprecision integral
+void word_chunks_16_mask_shift(benchmark::State& state)
+{
+    const auto words = make_random_words(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        typename BlueprintFieldType::integral_type sum = 0;
+        for (const auto& word : words)
+        {
+            typename BlueprintFieldType::integral_type mask = 0xffff;
+            for (size_t j = 0; j < 16; ++j)
+            {
+                sum += (word & mask) >> (16 * j);
+                mask <<= 16;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void rw_diff_indices(benchmark::State& state)
+{
+    const auto trace = make_rw_trace(static_cast<size_t>(state.range(0)));
+    const auto order = nil::evm_assigner::sort_rw_operations(trace);
+    std::vector<uint8_t> diff_indices(trace.size());
+    std::vector<typename BlueprintFieldType::value_type> differences;
+    for (auto _ : state)
+    {
+        nil::evm_assigner::rw_diff_indices(trace, order, 1, trace.size(), diff_indices, differences);
+        benchmark::DoNotOptimize(differences.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Previous way of finding diff indices: sorted columns are compared in the filled table
+void rw_diff_indices_from_table(benchmark::State& state)
+{
+    const auto trace = make_rw_trace(static_cast<size_t>(state.range(0)));
+    auto assignments = make_assignments();
+    auto& rw_table = assignments[assigner_type::RW_TABLE_INDEX];
+    nil::evm_assigner::process_rw_operations<BlueprintFieldType>(trace, rw_table, 1);
+
+    // op, id chunks, address chunks, field, storage key chunks, rw_id chunks
+    std::vector<uint32_t> sorting = {0};
+    for (uint32_t column = 20; column < 32; ++column)
+        sorting.push_back(column);
+    sorting.push_back(5);
+    for (uint32_t column = 32; column < 50; ++column)
+        sorting.push_back(column);
+
+    std::vector<uint8_t> diff_indices(trace.size());
+    std::vector<typename BlueprintFieldType::value_type> differences(trace.size());
+    for (auto _ : state)
+    {
+        for (uint32_t row = 1; row < trace.size(); ++row)
+        {
+            size_t diff_ind = 0;
+            while (diff_ind + 1 < sorting.size() &&
+                   rw_table.witness(sorting[diff_ind], row) == rw_table.witness(sorting[diff_ind], row - 1))
+                ++diff_ind;
+            diff_indices[row] = static_cast<uint8_t>(diff_ind);
+            differences[row] =
+                rw_table.witness(sorting[diff_ind], row) - rw_table.witness(sorting[diff_ind], row - 1);
+        }
+        benchmark::DoNotOptimize(differences.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void process_rw_operations(benchmark::State& state)
+{
+    const auto trace = make_rw_trace(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto assignments = make_assignments();
+        state.ResumeTiming();
+
+        nil::evm_assigner::process_rw_operations<BlueprintFieldType>(
+            trace, assignments[assigner_type::RW_TABLE_INDEX]);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void process_bytecode_input(benchmark::State& state)
+{
+    const auto code = make_random_code(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto assignments = make_assignments();
+        state.ResumeTiming();
+
+        nil::evm_assigner::process_bytecode_input<BlueprintFieldType>(
+            code.size(), code.data(), assignments[assigner_type::BYTECODE_TABLE_INDEX]);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+}  // namespace
+
+BENCHMARK_CAPTURE(evaluate, arithmetic, arithmetic_body)->RangeMultiplier(10)->Range(1'000, max_rows)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(evaluate, storage, storage_body)->RangeMultiplier(10)->Range(1'000, max_rows)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(evaluate, memory_expansion, memory_expansion_body)->RangeMultiplier(10)->Range(1'000, 100'000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(dispatch, arithmetic, arithmetic_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch, bitwise, bitwise_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch, stack, stack_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch, push, push_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch, memory, memory_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch, memory_expansion, memory_expansion_body)->RangeMultiplier(10)->Range(1'000, 100'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch, storage, storage_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(dispatch_specialized, arithmetic, arithmetic_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch_specialized, storage, storage_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_CAPTURE(dispatch_switch, arithmetic, arithmetic_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch_switch, stack, stack_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch_switch, jump, jump_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch_blocks, arithmetic, arithmetic_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch_blocks, stack, stack_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch_blocks, jump, jump_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch_cached_top, arithmetic, arithmetic_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch_cached_top, bitwise, bitwise_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch_cached_top, stack, stack_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch_cached_top, mixed, mixed_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch_switch, mixed, mixed_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch_decoded, arithmetic, arithmetic_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch_decoded, push, push_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch_decoded, jump, jump_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+#ifdef EVM_ASSIGNER_HAS_COMPUTED_GOTO
+BENCHMARK_CAPTURE(dispatch_computed_goto, arithmetic, arithmetic_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dispatch_computed_goto, jump, jump_body)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+#endif
+
+BENCHMARK_CAPTURE(analyze, plain, false, false)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(analyze, blocks, false, true)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(analyze, decoded, true, true)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(memory_grow_clear)->RangeMultiplier(16)->Range(4096, 64 << 20)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(host_get_balance)->RangeMultiplier(10)->Range(1'000, 1'000'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(host_storage)->RangeMultiplier(10)->Range(1'000, 1'000'000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(rw_sort)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK(word_chunks_16)->RangeMultiplier(10)->Range(1'000, max_rows)->Unit(benchmark::kMicrosecond);
+BENCHMARK(word_chunks_16_mask_shift)->RangeMultiplier(10)->Range(1'000, max_rows)->Unit(benchmark::kMicrosecond);
+BENCHMARK(rw_diff_indices)->RangeMultiplier(10)->Range(1'000, max_ops)->Unit(benchmark::kMicrosecond);
+BENCHMARK(rw_diff_indices_from_table)->RangeMultiplier(10)->Range(1'000, max_rows)->Unit(benchmark::kMicrosecond);
+BENCHMARK(process_rw_operations)->RangeMultiplier(10)->Range(1'000, max_rows)->Unit(benchmark::kMicrosecond);
+BENCHMARK(process_bytecode_input)->RangeMultiplier(10)->Range(1'000, max_rows)->Unit(benchmark::kMicrosecond);
@@ -4,6 +4,16 @@
 
 #include "baseline.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 #ifdef NDEBUG
 #define release_inline gnu::always_inline, msvc::forceinline
 #else
@@ -20,45 +30,240 @@ namespace evmone::baseline
 {
 namespace
 {
-CodeAnalysis::JumpdestMap analyze_jumpdests(bytes_view code)
+/// Number of bytes scanned at once by analyze_jumpdests().
+constexpr size_t scan_block_size = 32;
+
+// We need at most 33 bytes of code padding: 32 for possible missing all data bytes of PUSH32
+// at the very end of the code; and one more byte for STOP to guarantee there is a terminating
+// instruction at the code end. It also allows to scan the last block of the code.
+constexpr size_t code_padding = 32 + 1;
+static_assert(code_padding >= scan_block_size);
+
+/// Masks of JUMPDEST and PUSH opcodes in the block, i-th bit corresponds to i-th byte.
+/// Bytes are not known to be opcodes yet, the push data is skipped by the caller.
+struct BlockMasks
+{
+    uint32_t jumpdest;
+    uint32_t push;
+};
+
+inline BlockMasks scan_block(const uint8_t* block) noexcept
 {
     // To find if op is any PUSH opcode (OP_PUSH1 <= op <= OP_PUSH32)
     // it can be noticed that OP_PUSH32 is INT8_MAX (0x7f) therefore
     // static_cast<int8_t>(op) <= OP_PUSH32 is always true and can be skipped.
     static_assert(OP_PUSH32 == std::numeric_limits<int8_t>::max());
-
-    CodeAnalysis::JumpdestMap map(code.size());  // Allocate and init bitmap with zeros.
-    for (size_t i = 0; i < code.size(); ++i)
+#if defined(__AVX2__)
+    const auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    const auto jumpdest = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(OP_JUMPDEST));
+    const auto push = _mm256_cmpgt_epi8(bytes, _mm256_set1_epi8(OP_PUSH1 - 1));
+    return {static_cast<uint32_t>(_mm256_movemask_epi8(jumpdest)),
+        static_cast<uint32_t>(_mm256_movemask_epi8(push))};
+#elif defined(__SSE2__)
+    BlockMasks masks{};
+    for (size_t half = 0; half < 2; ++half)
     {
-        const auto op = code[i];
-        if (static_cast<int8_t>(op) >= OP_PUSH1)  // If any PUSH opcode (see explanation above).
-            i += op - size_t{OP_PUSH1 - 1};       // Skip PUSH data.
-        else if (op == OP_JUMPDEST)
-            map[i] = true;
+        const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * half));
+        const auto jumpdest = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(OP_JUMPDEST));
+        const auto push = _mm_cmpgt_epi8(bytes, _mm_set1_epi8(OP_PUSH1 - 1));
+        masks.jumpdest |= static_cast<uint32_t>(_mm_movemask_epi8(jumpdest)) << (16 * half);
+        masks.push |= static_cast<uint32_t>(_mm_movemask_epi8(push)) << (16 * half);
     }
+    return masks;
+#else
+    BlockMasks masks{};
+    for (size_t i = 0; i < scan_block_size; ++i)
+    {
+        masks.jumpdest |= uint32_t{block[i] == OP_JUMPDEST} << i;
+        masks.push |= uint32_t{static_cast<int8_t>(block[i]) >= OP_PUSH1} << i;
+    }
+    return masks;
+#endif
+}
 
-    return map;
+/// Sets bits of the bitmap starting from the given position.
+inline void set_bits(uint64_t* bitmap, size_t position, uint32_t bits) noexcept
+{
+    const auto shift = position % 64;
+    bitmap[position / 64] |= uint64_t{bits} << shift;
+    if (shift > 64 - scan_block_size)
+        bitmap[position / 64 + 1] |= uint64_t{bits} >> (64 - shift);
 }
 
-std::unique_ptr<uint8_t[]> pad_code(bytes_view code)
+/// Builds the bitmap of valid jump destinations of the padded code.
+/// The code is scanned by blocks, push data is skipped with the mask of valid bytes,
+/// so blocks without PUSH opcodes are processed without looking at single bytes.
+void analyze_jumpdests(const uint8_t* padded_code, size_t code_size, uint64_t* bitmap) noexcept
 {
-    // We need at most 33 bytes of code padding: 32 for possible missing all data bytes of PUSH32
-    // at the very end of the code; and one more byte for STOP to guarantee there is a terminating
-    // instruction at the code end.
-    constexpr auto padding = 32 + 1;
+    size_t i = 0;
+    while (i < code_size)
+    {
+        const auto masks = scan_block(&padded_code[i]);
+        uint32_t valid = ~uint32_t{0};
+        while (true)
+        {
+            const auto push = masks.push & valid;
+            if (push == 0)
+            {
+                set_bits(bitmap, i, masks.jumpdest & valid);
+                i += scan_block_size;
+                break;
+            }
 
-    // Using "raw" new operator instead of std::make_unique() to get uninitialized array.
-    std::unique_ptr<uint8_t[]> padded_code{new uint8_t[code.size() + padding]};
-    std::copy(std::begin(code), std::end(code), padded_code.get());
-    std::fill_n(&padded_code[code.size()], padding, uint8_t{OP_STOP});
-    return padded_code;
+            const auto push_position = static_cast<size_t>(std::countr_zero(push));
+            set_bits(bitmap, i, masks.jumpdest & valid & ((uint32_t{1} << push_position) - 1));
+            const auto next = push_position + 1 + (padded_code[i + push_position] - size_t{OP_PUSH1 - 1});
+            if (next >= scan_block_size)
+            {
+                i += next;
+                break;
+            }
+            valid = ~uint32_t{0} << next;
+        }
+    }
 }
 
+/// The table of instructions which could be checked at the basic block entry:
+/// defined in the interpreter and not using the gas counter.
+constexpr auto block_instructions = []() noexcept {
+    std::array<bool, 256> table{};
+#undef ON_OPCODE_IDENTIFIER
+#define ON_OPCODE_IDENTIFIER(OPCODE, IDENTIFIER) table[OPCODE] = !instr::uses_gas_counter[OPCODE];
+    MAP_OPCODES
+#undef ON_OPCODE_IDENTIFIER
+#define ON_OPCODE_IDENTIFIER ON_OPCODE_IDENTIFIER_DEFAULT
+    return table;
+}();
 
-CodeAnalysis analyze_legacy(bytes_view code)
+/// Splits the padded code into basic blocks and collects their requirements.
+/// The code is walked the same way as by analyze_jumpdests(), so every valid jump destination
+/// starts a block. The last block ends with the STOP from the padding.
+/// If decoded is not nullptr, the instructions are also pre-decoded into it.
+CodeAnalysis::BlockMap analyze_blocks(evmc_revision rev, const uint8_t* padded_code, size_t code_size,
+    const CodeAnalysis::JumpdestMap& jumpdest_map, CodeAnalysis::DecodedCode* decoded)
 {
-    // TODO: The padded code buffer and jumpdest bitmap can be created with single allocation.
-    return {pad_code(code), code.size(), analyze_jumpdests(code)};
+    using DecodedInstruction = CodeAnalysis::DecodedInstruction;
+
+    const auto& cost_table = get_baseline_cost_table(rev, 0);
+    std::vector<CodeAnalysis::BasicBlock> blocks;
+    std::vector<uint64_t> starts((code_size + code_padding + 63) / 64);
+    int32_t stack_change = 0;
+    bool block_begins = false;
+    // Jumps with the destination pushed right before, resolved when all blocks are known.
+    std::vector<std::pair<size_t, uint64_t>> static_jumps;
+
+    const auto begin_block = [&](size_t position) {
+        starts[position / 64] |= uint64_t{1} << (position % 64);
+        blocks.emplace_back();
+        stack_change = 0;
+        block_begins = true;
+    };
+
+    begin_block(0);
+    for (size_t i = 0;;)
+    {
+        const auto op = padded_code[i];
+        if (op == OP_JUMPDEST && blocks.back().num_instructions != 0)
+            begin_block(i);
+
+        auto& block = blocks.back();
+        const bool checked_at_entry = block_instructions[op] && cost_table[op] >= 0;
+        if (checked_at_entry)
+        {
+            block.gas_cost += cost_table[op];
+            block.stack_required =
+                std::max(block.stack_required, instr::traits[op].stack_height_required - stack_change);
+            stack_change += instr::traits[op].stack_height_change;
+            block.stack_max_growth = std::max(block.stack_max_growth, stack_change);
+            ++block.num_instructions;
+        }
+        else
+        {
+            block.checked_tail = true;
+        }
+
+        const size_t push_size = op >= OP_PUSH1 && op <= OP_PUSH32 ? op - size_t{OP_PUSH1 - 1} : 0;
+        if (decoded != nullptr)
+        {
+            auto& instructions = decoded->instructions;
+            DecodedInstruction instruction{op, static_cast<uint32_t>(i)};
+            if (block_begins)
+            {
+                instruction.block = static_cast<uint32_t>(blocks.size() - 1);
+                decoded->block_instructions.push_back(static_cast<uint32_t>(instructions.size()));
+            }
+            if (push_size != 0)
+            {
+                uint8_t data[32]{};
+                std::copy_n(&padded_code[i + 1], push_size, &data[sizeof(data) - push_size]);
+                instruction.arg = static_cast<uint32_t>(decoded->push_values.size());
+                decoded->push_values.push_back(intx::be::unsafe::load<intx::uint256>(data));
+            }
+            else if (op == OP_JUMP || op == OP_JUMPI)
+            {
+                instruction.arg = DecodedInstruction::dynamic_target;
+                const bool after_push = !block_begins && instructions.back().opcode >= OP_PUSH1 &&
+                                        instructions.back().opcode <= OP_PUSH32;
+                if (after_push)
+                {
+                    // Jumps use the low word of the destination as zkevm_word::to_uint64()
+                    static_jumps.emplace_back(instructions.size(),
+                        static_cast<uint64_t>(decoded->push_values[instructions.back().arg]));
+                }
+            }
+            instructions.push_back(instruction);
+        }
+        block_begins = false;
+
+        if (i >= code_size)  // The STOP from the padding.
+            break;
+
+        const auto next = i + 1 + push_size;
+        if (!checked_at_entry || op == OP_JUMP || op == OP_JUMPI)
+            begin_block(next);
+        i = next;
+    }
+
+    CodeAnalysis::BlockMap block_map{std::move(blocks), std::move(starts)};
+    for (const auto& [index, destination] : static_jumps)
+    {
+        // Every valid jump destination starts a block.
+        decoded->instructions[index].arg =
+            destination < jumpdest_map.size() && jumpdest_map[destination] ?
+                decoded->block_instructions[block_map.index(destination)] :
+                DecodedInstruction::bad_target;
+    }
+    return block_map;
+}
+
+CodeAnalysis analyze_legacy(evmc_revision rev, bytes_view code, bool decode, bool blocks)
+{
+    // The bitmap is followed by the padded code, both are in the single allocation.
+    // Bits are set up to the end of the last scanned block, so it takes one more word.
+    const auto bitmap_words = (code.size() + scan_block_size + 63) / 64;
+    const auto code_offset = (bitmap_words * sizeof(uint64_t) + CodeAnalysis::buffer_alignment - 1) /
+                             CodeAnalysis::buffer_alignment * CodeAnalysis::buffer_alignment;
+
+    // Using "raw" new operator instead of std::make_unique() to get uninitialized array.
+    CodeAnalysis::Buffer buffer{
+        new (std::align_val_t{CodeAnalysis::buffer_alignment}) uint8_t[code_offset + code.size() + code_padding]};
+    auto* const bitmap = reinterpret_cast<uint64_t*>(buffer.get());
+    auto* const padded_code = buffer.get() + code_offset;
+
+    std::fill_n(bitmap, bitmap_words, uint64_t{0});
+    std::copy(std::begin(code), std::end(code), padded_code);
+    std::fill_n(&padded_code[code.size()], code_padding, uint8_t{OP_STOP});
+    analyze_jumpdests(padded_code, code.size(), bitmap);
+
+    // Only dispatch_blocks() and dispatch_decoded() use the blocks, other loops skip building them.
+    CodeAnalysis::DecodedCode decoded;
+    CodeAnalysis::BlockMap block_map;
+    if (blocks || decode)
+        block_map = analyze_blocks(rev, padded_code, code.size(), {bitmap, code.size()},
+            decode ? &decoded : nullptr);
+
+    return {std::move(buffer), bitmap, padded_code, code.size(), std::move(block_map),
+        std::move(decoded)};
 }
 
 CodeAnalysis analyze_eof1(bytes_view container)
@@ -77,10 +282,10 @@ CodeAnalysis analyze_eof1(bytes_view container)
 }
 }  // namespace
 
-CodeAnalysis analyze(evmc_revision rev, bytes_view code)
+CodeAnalysis analyze(evmc_revision rev, bytes_view code, bool decode, bool blocks)
 {
     if (rev < EVMC_PRAGUE || !is_eof_container(code))
-        return analyze_legacy(code);
+        return analyze_legacy(rev, code, decode, blocks);
     return analyze_eof1(code);
 }
 }  // namespace evmone::baseline
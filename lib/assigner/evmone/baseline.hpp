@@ -10,8 +10,16 @@
 
 #include <evmc.h>
 #include <utils.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <new>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #ifdef NDEBUG
@@ -39,22 +47,155 @@ namespace baseline
 class CodeAnalysis
 {
 public:
-    using JumpdestMap = std::vector<bool>;
+    /// Packed bitmap of valid jump destinations, it refers to the memory owned by CodeAnalysis.
+    class JumpdestMap
+    {
+    public:
+        JumpdestMap() = default;
+
+        JumpdestMap(const uint64_t* bits, size_t size) noexcept : m_bits{bits}, m_size{size} {}
+
+        [[nodiscard]] size_t size() const noexcept { return m_size; }
+
+        [[nodiscard]] bool operator[](size_t index) const noexcept
+        {
+            return (m_bits[index / 64] >> (index % 64)) & 1;
+        }
+
+    private:
+        const uint64_t* m_bits = nullptr;
+        size_t m_size = 0;
+    };
+
+    /// Requirements of the basic block, see docs/efficient_gas_calculation_algorithm.md.
+    /// The block consists of the instructions with constant gas cost, which are checked
+    /// at the block entry, and optionally of the last instruction using the gas counter,
+    /// which is checked individually.
+    struct BasicBlock
+    {
+        /// Total base gas cost of the instructions checked at the block entry.
+        int64_t gas_cost = 0;
+        /// Number of the instructions checked at the block entry.
+        uint32_t num_instructions = 0;
+        /// Minimum stack height required to execute the block.
+        int32_t stack_required = 0;
+        /// Maximum stack height growth relative to the stack height at the block entry.
+        int32_t stack_max_growth = 0;
+        /// Whether the block ends with the instruction using the gas counter.
+        bool checked_tail = false;
+    };
+
+    /// Basic blocks of legacy code in code order and the bitmap of their starting positions.
+    class BlockMap
+    {
+    public:
+        BlockMap() = default;
+
+        BlockMap(std::vector<BasicBlock> blocks, std::vector<uint64_t> starts) noexcept
+          : m_blocks{std::move(blocks)}, m_starts{std::move(starts)}, m_ranks(m_starts.size())
+        {
+            uint32_t rank = 0;
+            for (size_t i = 0; i < m_starts.size(); ++i)
+            {
+                m_ranks[i] = rank;
+                rank += static_cast<uint32_t>(std::popcount(m_starts[i]));
+            }
+        }
+
+        [[nodiscard]] bool empty() const noexcept { return m_blocks.empty(); }
+
+        [[nodiscard]] size_t size() const noexcept { return m_blocks.size(); }
+
+        [[nodiscard]] bool is_block_start(size_t position) const noexcept
+        {
+            return position / 64 < m_starts.size() && ((m_starts[position / 64] >> (position % 64)) & 1);
+        }
+
+        /// Returns the index of the block starting at the given position of the code,
+        /// it is the number of blocks starting before the position.
+        [[nodiscard]] size_t index(size_t position) const noexcept
+        {
+            const auto bits = m_starts[position / 64] & ((uint64_t{1} << (position % 64)) - 1);
+            return m_ranks[position / 64] + static_cast<uint32_t>(std::popcount(bits));
+        }
+
+        /// Returns the block by its index.
+        [[nodiscard]] const BasicBlock& block(size_t index) const noexcept { return m_blocks[index]; }
+
+        /// Returns the block starting at the given position of the code.
+        [[nodiscard]] const BasicBlock& operator[](size_t position) const noexcept
+        {
+            return m_blocks[index(position)];
+        }
+
+    private:
+        std::vector<BasicBlock> m_blocks;
+        std::vector<uint64_t> m_starts;
+        std::vector<uint32_t> m_ranks;  ///< Number of blocks starting before every word of m_starts.
+    };
+
+    /// Instruction of legacy code pre-decoded for dispatch_decoded().
+    struct DecodedInstruction
+    {
+        /// Target of JUMP/JUMPI which destination is not known before execution.
+        static constexpr uint32_t dynamic_target = std::numeric_limits<uint32_t>::max();
+        /// Target of JUMP/JUMPI which destination is known to be invalid.
+        static constexpr uint32_t bad_target = dynamic_target - 1;
+        /// Block of the instruction which does not start a basic block.
+        static constexpr uint32_t no_block = std::numeric_limits<uint32_t>::max();
+
+        uint8_t opcode = OP_STOP;
+        /// Offset of the instruction in the code.
+        uint32_t code_offset = 0;
+        /// PUSH: index of the value in push_values.
+        /// JUMP/JUMPI: index of the target instruction if the destination is pushed right before.
+        uint32_t arg = 0;
+        /// Index of the basic block if the instruction starts it.
+        uint32_t block = no_block;
+    };
+
+    /// Legacy code pre-decoded into instructions, it is empty unless requested from analyze().
+    struct DecodedCode
+    {
+        std::vector<DecodedInstruction> instructions;
+        /// Values of PUSH instructions.
+        std::vector<intx::uint256> push_values;
+        /// Index of the first instruction of every basic block.
+        std::vector<uint32_t> block_instructions;
+    };
+
+    /// Alignment of the buffer holding the jumpdest bitmap and the padded code.
+    static constexpr size_t buffer_alignment = 64;
+
+    struct BufferDeleter
+    {
+        void operator()(uint8_t* p) const noexcept
+        {
+            ::operator delete[](p, std::align_val_t{buffer_alignment});
+        }
+    };
+    using Buffer = std::unique_ptr<uint8_t[], BufferDeleter>;
 
     bytes_view executable_code;  ///< Executable code section.
     JumpdestMap jumpdest_map;    ///< Map of valid jump destinations.
     EOF1Header eof_header;       ///< The EOF header.
+    BlockMap block_map;          ///< Basic blocks of legacy code.
+    DecodedCode decoded;         ///< Pre-decoded legacy code.
 
 private:
-    /// Padded code for faster legacy code execution.
-    /// If not nullptr the executable_code must point to it.
-    std::unique_ptr<uint8_t[]> m_padded_code;
+    /// Single buffer with the jumpdest bitmap followed by the padded code
+    /// for faster legacy code execution.
+    /// If not nullptr the executable_code and the jumpdest_map must point to it.
+    Buffer m_buffer;
 
 public:
-    CodeAnalysis(std::unique_ptr<uint8_t[]> padded_code, size_t code_size, JumpdestMap map)
-      : executable_code{padded_code.get(), code_size},
-        jumpdest_map{std::move(map)},
-        m_padded_code{std::move(padded_code)}
+    CodeAnalysis(Buffer buffer, const uint64_t* jumpdest_bits, const uint8_t* padded_code,
+        size_t code_size, BlockMap blocks, DecodedCode decoded_code)
+      : executable_code{padded_code, code_size},
+        jumpdest_map{jumpdest_bits, code_size},
+        block_map{std::move(blocks)},
+        decoded{std::move(decoded_code)},
+        m_buffer{std::move(buffer)}
     {}
 
     CodeAnalysis(bytes_view code, EOF1Header header)
@@ -66,10 +207,32 @@ static_assert(std::is_move_assignable_v<CodeAnalysis>);
 static_assert(!std::is_copy_constructible_v<CodeAnalysis>);
 static_assert(!std::is_copy_assignable_v<CodeAnalysis>);
 
-CodeAnalysis analyze(evmc_revision rev, bytes_view code);
+/// Revision for which evaluation uses the interpreter instantiated with revision checks
+/// resolved at compile time, other revisions check ExecutionState::rev on execution.
+inline constexpr evmc_revision specialized_revision = EVMC_LATEST_STABLE_REVISION;
+
+/// Whether analyze() pre-decodes legacy code by default, it is used by dispatch()
+/// only if the library is built with EVM_ASSIGNER_DECODED_DISPATCH.
+#if defined(EVM_ASSIGNER_DECODED_DISPATCH) && EVM_ASSIGNER_DECODED_DISPATCH
+inline constexpr bool decode_by_default = true;
+#else
+inline constexpr bool decode_by_default = false;
+#endif
+
+/// Whether analyze() builds the basic blocks of legacy code by default, they are used by dispatch()
+/// only if the library is built with EVM_ASSIGNER_BLOCK_GAS_CHECK or EVM_ASSIGNER_DECODED_DISPATCH.
+#if defined(EVM_ASSIGNER_BLOCK_GAS_CHECK) && EVM_ASSIGNER_BLOCK_GAS_CHECK
+inline constexpr bool blocks_by_default = true;
+#else
+inline constexpr bool blocks_by_default = decode_by_default;
+#endif
 
-/// Analyze the code to build the bitmap of valid JUMPDEST locations.
-EVMC_EXPORT CodeAnalysis analyze(evmc_revision rev, bytes_view code);
+/// Analyze the code to build the bitmap of valid JUMPDEST locations and basic blocks.
+/// @param decode  Whether to pre-decode legacy code for dispatch_decoded(), it implies blocks.
+/// @param blocks  Whether to build the block map for dispatch_blocks(). Without it the block map
+///                is empty and dispatch_blocks() runs dispatch_switch().
+EVMC_EXPORT CodeAnalysis analyze(evmc_revision rev, bytes_view code, bool decode = decode_by_default,
+    bool blocks = blocks_by_default);
 
 /// The execution position.
 template <typename BlueprintFieldType>
@@ -79,6 +242,18 @@ struct Position
     nil::evm_assigner::zkevm_word<BlueprintFieldType>* stack_top;     ///< The pointer to the stack top.
 };
 
+/// Returns the position where the execution starts: the beginning of the code
+/// or the instruction following CALL or CREATE which suspended the execution.
+template <typename BlueprintFieldType>
+inline Position<BlueprintFieldType> start_position(ExecutionState<BlueprintFieldType>& state, const uint8_t* code) noexcept
+{
+    const auto stack_bottom = state.stack_space.bottom();
+    const auto& call = state.suspended_call;
+    if (call.resume_pos == nullptr)
+        return {code, stack_bottom};
+    return {call.resume_pos, stack_bottom + call.stack_height};
+}
+
 /// Checks instruction requirements before execution.
 ///
 /// This checks:
@@ -87,6 +262,9 @@ struct Position
 /// - charges the instruction base gas cost and checks is there is any gas left.
 ///
 /// @tparam         Op            Instruction opcode.
+/// @tparam         Rev           The EVM revision if it is known at compile time. Before EOF
+///                               the cost table is the same for legacy and EOF code and costs
+///                               are taken from instr::gas_costs instead of cost_table.
 /// @param          cost_table    Table of base gas costs.
 /// @param [in,out] gas_left      Gas left.
 /// @param          stack_top     Pointer to the stack top item.
@@ -94,7 +272,7 @@ struct Position
 ///                               The stack height is stack_top - stack_bottom.
 /// @return  Status code with information which check has failed
 ///          or EVMC_SUCCESS if everything is fine.
-template <typename BlueprintFieldType>
+template <typename BlueprintFieldType, evmc_revision Rev = any_revision>
 inline evmc_status_code check_requirements(const CostTable& cost_table, int64_t& gas_left,
                                            const nil::evm_assigner::zkevm_word<BlueprintFieldType>* stack_top,
                                            const nil::evm_assigner::zkevm_word<BlueprintFieldType>* stack_bottom,
@@ -106,7 +284,10 @@ inline evmc_status_code check_requirements(const CostTable& cost_table, int64_t&
     auto gas_cost = instr::gas_costs[EVMC_FRONTIER][op];  // Init assuming const cost.
     if (!instr::has_const_gas_cost(op))
     {
-        gas_cost = cost_table[op];  // If not, load the cost from the table.
+        if constexpr (Rev != any_revision && Rev < EVMC_PRAGUE)
+            gas_cost = instr::gas_costs[Rev][op];
+        else
+            gas_cost = cost_table[op];  // If not, load the cost from the table.
 
         // Negative cost marks an undefined instruction.
         // This check must be first to produce correct error code.
@@ -162,6 +343,9 @@ template <typename BlueprintFieldType>
     gas = o.gas_left;
     if (o.status != EVMC_SUCCESS)
     {
+        // CALL and CREATE are single byte instructions
+        if (o.status == suspended_status)
+            state.suspended_call.resume_pos = pos.code_it + 1;
         state.status = o.status;
         return nullptr;
     }
@@ -194,51 +378,86 @@ template <typename BlueprintFieldType>
     state.status = result.status;
     return nullptr;
 }
-/// A helper to invoke the instruction implementation of the given opcode Op.
+/// Whether the instruction implementation receives the gas counter.
 template <typename BlueprintFieldType>
-[[release_inline]] inline Position<BlueprintFieldType> invoke(const CostTable& cost_table, const nil::evm_assigner::zkevm_word<BlueprintFieldType>* stack_bottom,
+constexpr bool receives_gas_counter(Result (*)(StackTop<BlueprintFieldType>, int64_t,
+    ExecutionState<BlueprintFieldType>&) noexcept) noexcept
+{
+    return true;
+}
+
+template <typename BlueprintFieldType>
+constexpr bool receives_gas_counter(TermResult (*)(StackTop<BlueprintFieldType>, int64_t,
+    ExecutionState<BlueprintFieldType>&) noexcept) noexcept
+{
+    return true;
+}
+
+template <typename InstrFn>
+constexpr bool receives_gas_counter(InstrFn /*fn*/) noexcept
+{
+    return false;
+}
+
+/// A helper to invoke the instruction implementation of the given opcode Op
+/// without checking its requirements.
+template <bool TracingEnabled, evmc_revision Rev = any_revision, typename BlueprintFieldType>
+[[release_inline]] inline Position<BlueprintFieldType> invoke_unchecked(
     Position<BlueprintFieldType> pos, int64_t& gas, ExecutionState<BlueprintFieldType>& state, const uint8_t& op) noexcept
 {
-    if (const auto status = check_requirements<BlueprintFieldType>(cost_table, gas, pos.stack_top, stack_bottom, Opcode(op));
-        status != EVMC_SUCCESS)
-    {
-        state.status = status;
-        return {nullptr, pos.stack_top};
-    }
     code_iterator new_pos = pos.code_it;
     switch (op)
     {
 #undef ON_OPCODE_IDENTIFIER
-#define ON_OPCODE_IDENTIFIER(OPCODE, IDENTIFIER)                         \
-case OPCODE:                                                             \
-    ASM_COMMENT(OPCODE);                                                 \
-    new_pos = invoke(instr::core::IDENTIFIER, pos, gas, state);          \
+#define ON_OPCODE_IDENTIFIER(OPCODE, IDENTIFIER)                                           \
+case OPCODE:                                                                               \
+    static_assert(instr::uses_gas_counter[OPCODE] ==                                       \
+                      receives_gas_counter(instr::core::IDENTIFIER),                       \
+        "instr::uses_gas_counter does not match the implementation of " #OPCODE);          \
+    ASM_COMMENT(OPCODE);                                                                   \
+    new_pos = invoke(instr::core::IDENTIFIER, pos, gas, state);                            \
     break;
     MAP_OPCODES
 #undef ON_OPCODE_IDENTIFIER
 
     default:
         state.status = EVMC_UNDEFINED_INSTRUCTION;
-        return {nullptr, pos.stack_top};;
+        return {nullptr, pos.stack_top};
     }
     const auto new_stack_top = pos.stack_top + instr::traits[op].stack_height_change;
     return Position<BlueprintFieldType>(new_pos, new_stack_top);
 }
+
+/// A helper to check the requirements and invoke the instruction implementation of the given opcode Op.
+template <bool TracingEnabled, evmc_revision Rev = any_revision, typename BlueprintFieldType>
+[[release_inline]] inline Position<BlueprintFieldType> invoke(const CostTable& cost_table, const nil::evm_assigner::zkevm_word<BlueprintFieldType>* stack_bottom,
+    Position<BlueprintFieldType> pos, int64_t& gas, ExecutionState<BlueprintFieldType>& state, const uint8_t& op) noexcept
+{
+    if (const auto status = check_requirements<BlueprintFieldType, Rev>(cost_table, gas, pos.stack_top, stack_bottom, Opcode(op));
+        status != EVMC_SUCCESS)
+    {
+        state.status = status;
+        return {nullptr, pos.stack_top};
+    }
+    return invoke_unchecked<TracingEnabled, Rev>(pos, gas, state, op);
+}
 /// @}
 
-template <bool TracingEnabled, typename BlueprintFieldType>
-int64_t dispatch(const CostTable& cost_table, ExecutionState<BlueprintFieldType>& state, int64_t gas,
+/// Executes the code until termination with the loop over the switch in invoke().
+/// @tparam TracingEnabled  Whether instructions record read/write operations into state.rw_trace.
+template <bool TracingEnabled, evmc_revision Rev = any_revision, typename BlueprintFieldType>
+int64_t dispatch_switch(const CostTable& cost_table, ExecutionState<BlueprintFieldType>& state, int64_t gas,
     const uint8_t* code) noexcept
 {
     const auto stack_bottom = state.stack_space.bottom();
 
     // Code iterator and stack top pointer for interpreter loop.
-    Position<BlueprintFieldType> position{code, stack_bottom};
+    auto position = start_position(state, code);
 
     while (true)  // Guaranteed to terminate because padded code ends with STOP.
     {
         const auto op = *position.code_it;
-        const auto next = invoke<BlueprintFieldType>(cost_table, stack_bottom, position, gas, state, op);
+        const auto next = invoke<TracingEnabled, Rev>(cost_table, stack_bottom, position, gas, state, op);
         if (next.code_it == nullptr)
         {
             return gas;
@@ -250,5 +469,462 @@ int64_t dispatch(const CostTable& cost_table, ExecutionState<BlueprintFieldType>
     }
 }
 
+#if defined(__GNUC__)
+#define EVM_ASSIGNER_HAS_COMPUTED_GOTO 1
+
+/// Table of jump targets of dispatch_computed_goto(), opcodes which are not listed jump to undefined.
+inline std::array<void*, 256> make_dispatch_targets(
+    void* undefined, std::initializer_list<std::pair<uint8_t, void*>> defined) noexcept
+{
+    std::array<void*, 256> targets;
+    targets.fill(undefined);
+    for (const auto& [opcode, target] : defined)
+        targets[opcode] = target;
+    return targets;
+}
+
+/// Executes the code until termination with computed goto (GCC/Clang extension).
+/// Every instruction handler jumps to the handler of the next instruction by itself,
+/// so each of them has its own indirect branch with separate prediction history,
+/// and requirements are checked with the opcode known at compile time.
+/// @tparam TracingEnabled  Whether instructions record read/write operations into state.rw_trace.
+template <bool TracingEnabled, evmc_revision Rev = any_revision, typename BlueprintFieldType>
+int64_t dispatch_computed_goto(const CostTable& cost_table, ExecutionState<BlueprintFieldType>& state,
+    int64_t gas, const uint8_t* code) noexcept
+{
+    const auto stack_bottom = state.stack_space.bottom();
+
+    // Code iterator and stack top pointer for interpreter loop.
+    auto position = start_position(state, code);
+
+    // Addresses of the labels are taken in the initializer, so the table is built once per instantiation.
+    // MAP_OPCODES is not ordered by opcode, so the table is built from pairs instead of a positional list.
+#undef ON_OPCODE_IDENTIFIER
+#define ON_OPCODE_IDENTIFIER(OPCODE, IDENTIFIER) {OPCODE, &&TARGET_##OPCODE},
+    static const std::array<void*, 256> targets = make_dispatch_targets(&&TARGET_UNDEFINED, {MAP_OPCODES});
+#undef ON_OPCODE_IDENTIFIER
+
+    // Guaranteed to terminate because padded code ends with STOP.
+    goto* targets[*position.code_it];
+
+#define ON_OPCODE_IDENTIFIER(OPCODE, IDENTIFIER)                                                   \
+TARGET_##OPCODE:                                                                                   \
+    ASM_COMMENT(OPCODE);                                                                           \
+    if (const auto status = check_requirements<BlueprintFieldType, Rev>(                           \
+            cost_table, gas, position.stack_top, stack_bottom, OPCODE);                            \
+        status != EVMC_SUCCESS)                                                                    \
+    {                                                                                              \
+        state.status = status;                                                                     \
+        return gas;                                                                                \
+    }                                                                                              \
+    if (const auto next = invoke(instr::core::IDENTIFIER, position, gas, state); next == nullptr)  \
+        return gas;                                                                                \
+    else                                                                                           \
+        position = {next, position.stack_top + instr::traits[OPCODE].stack_height_change};        \
+    goto* targets[*position.code_it];
+    MAP_OPCODES
+#undef ON_OPCODE_IDENTIFIER
+
+TARGET_UNDEFINED:
+    state.status = EVMC_UNDEFINED_INSTRUCTION;
+    return gas;
+}
+#endif
+
+/// Executes the code until termination checking requirements once per basic block,
+/// see docs/efficient_gas_calculation_algorithm.md.
+/// If the block requirements are not satisfied, its instructions are checked individually,
+/// so the execution stops at the same instruction with the same status and gas left
+/// as with dispatch_switch(). EOF code is executed by dispatch_switch().
+/// @tparam TracingEnabled  Whether instructions record read/write operations into state.rw_trace.
+template <bool TracingEnabled, evmc_revision Rev = any_revision, typename BlueprintFieldType>
+int64_t dispatch_blocks(const CostTable& cost_table, ExecutionState<BlueprintFieldType>& state, int64_t gas,
+    const uint8_t* code) noexcept
+{
+    const auto& block_map = state.analysis.baseline->block_map;
+    if (block_map.empty())
+        return dispatch_switch<TracingEnabled, Rev>(cost_table, state, gas, code);
+
+    const auto stack_bottom = state.stack_space.bottom();
+
+    // Code iterator and stack top pointer for interpreter loop.
+    auto position = start_position(state, code);
+
+    while (true)  // Guaranteed to terminate because the last block ends with STOP.
+    {
+        const auto& block = block_map[static_cast<size_t>(position.code_it - code)];
+        const auto stack_height = position.stack_top - stack_bottom;
+
+        uint32_t unchecked = 0;
+        if (stack_height >= block.stack_required &&
+            stack_height + block.stack_max_growth <= StackSpace<BlueprintFieldType>::limit &&
+            gas >= block.gas_cost)
+        {
+            gas -= block.gas_cost;
+            unchecked = block.num_instructions;
+        }
+
+        for (uint32_t i = 0; i < unchecked; ++i)
+        {
+            const auto next = invoke_unchecked<TracingEnabled, Rev>(position, gas, state, *position.code_it);
+            if (next.code_it == nullptr)
+                return gas;
+            position = next;
+        }
+
+        const auto checked = block.num_instructions - unchecked + uint32_t{block.checked_tail};
+        for (uint32_t i = 0; i < checked; ++i)
+        {
+            const auto next = invoke<TracingEnabled, Rev>(
+                cost_table, stack_bottom, position, gas, state, *position.code_it);
+            if (next.code_it == nullptr)
+                return gas;
+            position = next;
+        }
+    }
+}
+
+/// Executes the pre-decoded instruction, checking its requirements if Checked.
+/// PUSH values and static jump targets are taken from the decoded code, other instructions
+/// are invoked with their position in the code.
+/// @return  The next instruction or nullptr if the execution terminates.
+template <bool Checked, bool TracingEnabled, evmc_revision Rev, typename BlueprintFieldType>
+[[release_inline]] inline const CodeAnalysis::DecodedInstruction* invoke_decoded(const CostTable& cost_table,
+    const CodeAnalysis& analysis, const CodeAnalysis::DecodedInstruction* it,
+    nil::evm_assigner::zkevm_word<BlueprintFieldType>*& stack_top,
+    const nil::evm_assigner::zkevm_word<BlueprintFieldType>* stack_bottom, int64_t& gas,
+    ExecutionState<BlueprintFieldType>& state) noexcept
+{
+    using DecodedInstruction = CodeAnalysis::DecodedInstruction;
+    using instructions = instr::core::instructions<BlueprintFieldType, TracingEnabled, Rev>;
+
+    const auto op = it->opcode;
+    if constexpr (Checked)
+    {
+        if (const auto status = check_requirements<BlueprintFieldType, Rev>(cost_table, gas, stack_top, stack_bottom, Opcode(op));
+            status != EVMC_SUCCESS)
+        {
+            state.status = status;
+            return nullptr;
+        }
+    }
+
+    StackTop<BlueprintFieldType> stack{stack_top};
+    if (op >= OP_PUSH1 && op <= OP_PUSH32)
+    {
+        stack.push(nil::evm_assigner::zkevm_word<BlueprintFieldType>(analysis.decoded.push_values[it->arg]));
+        instructions::trace_push(stack, state);
+        ++stack_top;
+        return it + 1;
+    }
+
+    if (op == OP_JUMP || op == OP_JUMPI)
+    {
+        if (op == OP_JUMPI)
+            instructions::trace_stack(stack, state, 1, false);
+        instructions::trace_stack(stack, state, 0, false);
+        const auto& dst = stack.pop();
+        stack_top += instr::traits[op].stack_height_change;
+        if (op == OP_JUMPI && stack.pop().to_uint64() == 0)
+            return it + 1;
+
+        auto target = it->arg;
+        if (target == DecodedInstruction::dynamic_target)
+        {
+            const auto dst_uint64 = dst.to_uint64();
+            target = dst_uint64 < analysis.jumpdest_map.size() && analysis.jumpdest_map[dst_uint64] ?
+                         analysis.decoded.block_instructions[analysis.block_map.index(dst_uint64)] :
+                         DecodedInstruction::bad_target;
+        }
+        if (target == DecodedInstruction::bad_target)
+        {
+            state.status = EVMC_BAD_JUMP_DESTINATION;
+            return nullptr;
+        }
+        return &analysis.decoded.instructions[target];
+    }
+
+    const auto next = invoke_unchecked<TracingEnabled, Rev>(
+        Position<BlueprintFieldType>{&analysis.executable_code[it->code_offset], stack_top}, gas, state, op);
+    if (next.code_it == nullptr)
+        return nullptr;
+    stack_top = next.stack_top;
+    return it + 1;
+}
+
+/// Executes the pre-decoded code until termination, requirements are checked per basic block
+/// as in dispatch_blocks(). PUSH data is not decoded and static jump destinations are not
+/// checked on every execution. Results are the same as with dispatch_switch().
+/// Code which is not pre-decoded is executed by dispatch_blocks().
+/// @tparam TracingEnabled  Whether instructions record read/write operations into state.rw_trace.
+template <bool TracingEnabled, evmc_revision Rev = any_revision, typename BlueprintFieldType>
+int64_t dispatch_decoded(const CostTable& cost_table, ExecutionState<BlueprintFieldType>& state, int64_t gas,
+    const uint8_t* code) noexcept
+{
+    const auto& analysis = *state.analysis.baseline;
+    if (analysis.decoded.instructions.empty())
+        return dispatch_blocks<TracingEnabled, Rev>(cost_table, state, gas, code);
+
+    const auto stack_bottom = state.stack_space.bottom();
+    const auto start = start_position(state, code);
+    auto stack_top = start.stack_top;
+    // The instruction following CALL or CREATE starts a basic block.
+    const auto* it = &analysis.decoded.instructions[analysis.decoded.block_instructions[
+        analysis.block_map.index(static_cast<size_t>(start.code_it - code))]];
+
+    while (true)  // Guaranteed to terminate because the last block ends with STOP.
+    {
+        const auto& block = analysis.block_map.block(it->block);
+        const auto stack_height = stack_top - stack_bottom;
+
+        uint32_t unchecked = 0;
+        if (stack_height >= block.stack_required &&
+            stack_height + block.stack_max_growth <= StackSpace<BlueprintFieldType>::limit &&
+            gas >= block.gas_cost)
+        {
+            gas -= block.gas_cost;
+            unchecked = block.num_instructions;
+        }
+
+        for (uint32_t i = 0; i < unchecked; ++i)
+        {
+            it = invoke_decoded<false, TracingEnabled, Rev>(cost_table, analysis, it, stack_top, stack_bottom, gas, state);
+            if (it == nullptr)
+                return gas;
+        }
+
+        const auto checked = block.num_instructions - unchecked + uint32_t{block.checked_tail};
+        for (uint32_t i = 0; i < checked; ++i)
+        {
+            it = invoke_decoded<true, TracingEnabled, Rev>(cost_table, analysis, it, stack_top, stack_bottom, gas, state);
+            if (it == nullptr)
+                return gas;
+        }
+    }
+}
+
+/// The stack of dispatch_cached_top() with the top item kept in a local variable.
+/// The stack space slot of the top item is stale until the item is spilled.
+template <bool TracingEnabled, typename BlueprintFieldType>
+struct CachedTopStack
+{
+    using word_type = nil::evm_assigner::zkevm_word<BlueprintFieldType>;
+
+    word_type* const bottom;
+    word_type* top_ptr;  ///< The pointer to the slot of the top item.
+    word_type top;       ///< The top item if the stack is not empty.
+
+    /// Writes the top item into its slot, so the stack space is up to date.
+    void spill() noexcept
+    {
+        if (top_ptr != bottom)
+            *top_ptr = top;
+    }
+
+    /// Reads the top item from its slot after the stack space is modified.
+    void reload() noexcept
+    {
+        if (top_ptr != bottom)
+            top = *top_ptr;
+    }
+
+    /// Returns the item by index, where 0 means the top item.
+    [[nodiscard]] const word_type& operator[](int index) const noexcept
+    {
+        return index == 0 ? top : top_ptr[-index];
+    }
+
+    /// Pushes the item, the previous top item is spilled.
+    void push(const word_type& value) noexcept
+    {
+        spill();
+        ++top_ptr;
+        top = value;
+    }
+
+    /// Records access to the item as instructions::trace_stack() does.
+    void trace([[maybe_unused]] ExecutionState<BlueprintFieldType>& state, [[maybe_unused]] int index,
+        [[maybe_unused]] bool is_write) const noexcept
+    {
+        if constexpr (TracingEnabled)
+        {
+            const uint16_t size = top_ptr > bottom ? static_cast<uint16_t>(top_ptr - bottom) : 0;
+            state.rw_trace.push_stack(state.call_id, size - 1 - index, state.rw_trace.size(), is_write, (*this)[index]);
+        }
+    }
+
+    /// Replaces two top items with the result of op(top, second) tracing them as binary instructions.
+    template <typename Op>
+    void binary_op(ExecutionState<BlueprintFieldType>& state, Op op) noexcept
+    {
+        trace(state, 1, false);
+        trace(state, 0, false);
+        --top_ptr;
+        top = op(top, *top_ptr);
+        trace(state, 0, true);
+    }
+};
+
+/// Executes the code until termination keeping the top stack item in a local variable.
+/// Arithmetic, comparison, bitwise, PUSH, DUP, SWAP and POP instructions work on the cached item,
+/// other instructions are invoked after the item is spilled into the stack space.
+/// The RW trace, gas and status are the same as with dispatch_switch().
+/// @tparam TracingEnabled  Whether instructions record read/write operations into state.rw_trace.
+template <bool TracingEnabled, evmc_revision Rev = any_revision, typename BlueprintFieldType>
+int64_t dispatch_cached_top(const CostTable& cost_table, ExecutionState<BlueprintFieldType>& state,
+    int64_t gas, const uint8_t* code) noexcept
+{
+    using word_type = nil::evm_assigner::zkevm_word<BlueprintFieldType>;
+    using instructions = instr::core::instructions<BlueprintFieldType, TracingEnabled, Rev>;
+
+    const auto stack_bottom = state.stack_space.bottom();
+    const auto start = start_position(state, code);
+    CachedTopStack<TracingEnabled, BlueprintFieldType> stack{stack_bottom, start.stack_top, {}};
+    stack.reload();
+    code_iterator pc = start.code_it;
+
+    while (true)  // Guaranteed to terminate because padded code ends with STOP.
+    {
+        const auto op = *pc;
+        if (const auto status = check_requirements<BlueprintFieldType, Rev>(
+                cost_table, gas, stack.top_ptr, stack_bottom, Opcode(op));
+            status != EVMC_SUCCESS)
+        {
+            stack.spill();
+            state.status = status;
+            return gas;
+        }
+
+        switch (op)
+        {
+        case OP_ADD:
+            stack.binary_op(state, [](const word_type& a, const word_type& b) { return b + a; });
+            break;
+        case OP_MUL:
+            stack.binary_op(state, [](const word_type& a, const word_type& b) { return b * a; });
+            break;
+        case OP_SUB:
+            stack.binary_op(state, [](const word_type& a, const word_type& b) { return a - b; });
+            break;
+        case OP_LT:
+            stack.binary_op(state, [](const word_type& a, const word_type& b) { return word_type(a < b); });
+            break;
+        case OP_GT:
+            stack.binary_op(state, [](const word_type& a, const word_type& b) { return word_type(b < a); });
+            break;
+        case OP_EQ:
+            stack.binary_op(state, [](const word_type& a, const word_type& b) { return word_type(b == a); });
+            break;
+        case OP_AND:
+            stack.binary_op(state, [](const word_type& a, const word_type& b) { return b & a; });
+            break;
+        case OP_OR:
+            stack.binary_op(state, [](const word_type& a, const word_type& b) { return b | a; });
+            break;
+        case OP_XOR:
+            stack.binary_op(state, [](const word_type& a, const word_type& b) { return b ^ a; });
+            break;
+        case OP_ISZERO:
+            stack.trace(state, 0, false);
+            stack.top = word_type(stack.top == 0);
+            stack.trace(state, 0, true);
+            break;
+        case OP_NOT:
+            stack.trace(state, 0, false);
+            stack.top = ~stack.top;
+            stack.trace(state, 0, true);
+            break;
+        case OP_POP:
+            --stack.top_ptr;
+            stack.reload();
+            break;
+        case OP_JUMPDEST:
+            break;
+        case OP_PUSH0:
+            stack.push(word_type{});
+            stack.trace(state, 0, true);
+            break;
+        default:
+            if (op >= OP_PUSH1 && op <= OP_PUSH32)
+            {
+                const size_t len = op - size_t{OP_PUSH1 - 1};
+                stack.push(word_type{});
+                instructions::load_push_data(stack.top, pc + 1, len);
+                stack.trace(state, 0, true);
+                pc += len + 1;
+                continue;
+            }
+            if (op >= OP_DUP1 && op <= OP_DUP16)
+            {
+                const int index = op - OP_DUP1;
+                stack.trace(state, index, false);
+                stack.push(word_type{stack[index]});
+                stack.trace(state, 0, true);
+                ++pc;
+                continue;
+            }
+            if (op >= OP_SWAP1 && op <= OP_SWAP16)
+            {
+                const int index = op - OP_SWAP1 + 1;
+                stack.trace(state, index, false);
+                stack.trace(state, 0, false);
+                std::swap(stack.top, stack.top_ptr[-index]);
+                stack.trace(state, 0, true);
+                stack.trace(state, index - 1, true);
+                ++pc;
+                continue;
+            }
+
+            stack.spill();
+            const auto next = invoke_unchecked<TracingEnabled, Rev>(
+                Position<BlueprintFieldType>{pc, stack.top_ptr}, gas, state, op);
+            if (next.code_it == nullptr)
+                return gas;
+            pc = next.code_it;
+            stack.top_ptr = next.stack_top;
+            stack.reload();
+            continue;
+        }
+        ++pc;
+    }
+}
+
+/// Executes the code until termination.
+/// Computed goto dispatch is used if the library is built with EVM_ASSIGNER_COMPUTED_GOTO,
+/// requirements are checked per basic block if it is built with EVM_ASSIGNER_BLOCK_GAS_CHECK,
+/// pre-decoded code is executed if it is built with EVM_ASSIGNER_DECODED_DISPATCH
+/// and the top stack item is cached if it is built with EVM_ASSIGNER_CACHED_TOP.
+/// The execution suspended by CALL or CREATE continues from the instruction following it,
+/// see ExecutionState::suspend_calls.
+/// @tparam TracingEnabled  Whether instructions record read/write operations into state.rw_trace.
+/// @tparam Rev             The revision of state if the loop is instantiated for it,
+///                         see specialized_revision.
+template <bool TracingEnabled, evmc_revision Rev = any_revision, typename BlueprintFieldType>
+int64_t dispatch(const CostTable& cost_table, ExecutionState<BlueprintFieldType>& state, int64_t gas,
+    const uint8_t* code) noexcept
+{
+#if (defined(EVM_ASSIGNER_BLOCK_GAS_CHECK) && EVM_ASSIGNER_BLOCK_GAS_CHECK ||       \
+        defined(EVM_ASSIGNER_DECODED_DISPATCH) && EVM_ASSIGNER_DECODED_DISPATCH) + \
+        (defined(EVM_ASSIGNER_COMPUTED_GOTO) && EVM_ASSIGNER_COMPUTED_GOTO) +      \
+        (defined(EVM_ASSIGNER_CACHED_TOP) && EVM_ASSIGNER_CACHED_TOP) >            \
+    1
+#error "EVM_ASSIGNER_COMPUTED_GOTO, EVM_ASSIGNER_CACHED_TOP and block dispatch are mutually exclusive"
+#endif
+#if defined(EVM_ASSIGNER_CACHED_TOP) && EVM_ASSIGNER_CACHED_TOP
+    return dispatch_cached_top<TracingEnabled, Rev>(cost_table, state, gas, code);
+#elif defined(EVM_ASSIGNER_DECODED_DISPATCH) && EVM_ASSIGNER_DECODED_DISPATCH
+    return dispatch_decoded<TracingEnabled, Rev>(cost_table, state, gas, code);
+#elif defined(EVM_ASSIGNER_BLOCK_GAS_CHECK) && EVM_ASSIGNER_BLOCK_GAS_CHECK
+    return dispatch_blocks<TracingEnabled, Rev>(cost_table, state, gas, code);
+#elif defined(EVM_ASSIGNER_COMPUTED_GOTO) && EVM_ASSIGNER_COMPUTED_GOTO
+#if !defined(EVM_ASSIGNER_HAS_COMPUTED_GOTO)
+#error "Computed goto dispatch requires GCC or Clang"
+#endif
+    return dispatch_computed_goto<TracingEnabled, Rev>(cost_table, state, gas, code);
+#else
+    return dispatch_switch<TracingEnabled, Rev>(cost_table, state, gas, code);
+#endif
+}
+
 }  // namespace baseline
 }  // namespace evmone
@@ -4,12 +4,20 @@
 #pragma once
 
 #include <evmc.hpp>
+#include <algorithm>
 #include <string>
 #include <vector>
 
 #include <zkevm_word.hpp>
 #include <rw.hpp>
 
+#if defined(EVM_ASSIGNER_MMAP_MEMORY) && EVM_ASSIGNER_MMAP_MEMORY
+#if !defined(__linux__)
+#error "EVM_ASSIGNER_MMAP_MEMORY relies on zero pages after MADV_DONTNEED, which is Linux behaviour"
+#endif
+#include <sys/mman.h>
+#endif
+
 namespace nil {
     namespace evm_assigner {
         template<typename BlueprintFieldType>
@@ -47,6 +55,94 @@ private:
 };
 
 
+#if defined(EVM_ASSIGNER_MMAP_MEMORY) && EVM_ASSIGNER_MMAP_MEMORY
+/// The EVM memory.
+///
+/// The implementation maps an address range without reserving pages on the first growth. The kernel
+/// maps pages on the first access and they are filled with zeros, so the memory grows without filling.
+/// The range is doubled with mremap(), which moves mapped pages without copying.
+class Memory
+{
+    /// The size of the range mapped on the first growth.
+    static constexpr size_t initial_capacity = 1024 * 1024;
+
+    /// Memory which is smaller is zeroed by clear(), larger one is returned to the kernel.
+    static constexpr size_t release_threshold = 64 * 1024;
+
+    /// Pointer to the mapped range, null before the first growth.
+    uint8_t* m_data = nullptr;
+
+    /// The "virtual" size of the memory.
+    size_t m_size = 0;
+
+    /// The size of the mapped range.
+    size_t m_capacity = 0;
+
+    /// Maps the range of at least the given size keeping the content.
+    /// Returns false if the address space is exhausted.
+    [[nodiscard]] bool reserve(size_t new_size) noexcept
+    {
+        size_t capacity = std::max(m_capacity * 2, initial_capacity);
+        while (capacity < new_size)
+            capacity *= 2;
+
+        void* const data = m_data == nullptr ?
+            mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0) :
+            mremap(m_data, m_capacity, capacity, MREMAP_MAYMOVE);
+        if (data == MAP_FAILED)
+            return false;
+        m_data = static_cast<uint8_t*>(data);
+        m_capacity = capacity;
+        return true;
+    }
+
+public:
+    /// Creates Memory object without mapping, frames which do not use memory take no address space.
+    Memory() noexcept = default;
+
+    /// Unmaps the range.
+    ~Memory() noexcept
+    {
+        if (m_data != nullptr)
+            munmap(m_data, m_capacity);
+    }
+
+    Memory(const Memory&) = delete;
+    Memory& operator=(const Memory&) = delete;
+
+    uint8_t& operator[](size_t index) noexcept { return m_data[index]; }
+
+    [[nodiscard]] const uint8_t* data() const noexcept { return m_data; }
+    [[nodiscard]] size_t size() const noexcept { return m_size; }
+
+    /// Grows the memory to the given size. The memory after the size has never been written
+    /// since the last clear(), so the extend is already zero.
+    ///
+    /// @param new_size  New memory size. Must be larger than the current size and multiple of 32.
+    /// @return          False if the range could not be mapped, the memory is not changed then.
+    [[nodiscard]] bool grow(size_t new_size) noexcept
+    {
+        assert(new_size % 32 == 0);
+        assert(new_size > m_size);
+
+        if (new_size > m_capacity && !reserve(new_size))
+            return false;
+        m_size = new_size;
+        return true;
+    }
+
+    /// Clears the memory by setting its size to 0. Written bytes are zeroed again, pages of large
+    /// memory are replaced with zero pages by the kernel. The range stays mapped.
+    void clear() noexcept
+    {
+        if (m_size > release_threshold)
+            madvise(m_data, m_size, MADV_DONTNEED);
+        else if (m_size != 0)
+            std::memset(m_data, 0, m_size);
+        m_size = 0;
+    }
+};
+#else
 /// The EVM memory.
 ///
 /// The implementations uses initial allocation of 4k and then grows capacity with 2x factor.
@@ -92,7 +188,8 @@ public:
     /// Grows the memory to the given size. The extend is filled with zeros.
     ///
     /// @param new_size  New memory size. Must be larger than the current size and multiple of 32.
-    void grow(size_t new_size) noexcept
+    /// @return          Always true, failed allocation terminates.
+    [[nodiscard]] bool grow(size_t new_size) noexcept
     {
         // Restriction for future changes. EVM always has memory size as multiple of 32 bytes.
         assert(new_size % 32 == 0);
@@ -114,11 +211,37 @@ public:
         }
         std::memset(m_data + m_size, 0, new_size - m_size);
         m_size = new_size;
+        return true;
     }
 
     /// Virtually clears the memory by setting its size to 0. The capacity stays unchanged.
     void clear() noexcept { m_size = 0; }
 };
+#endif
+
+/// Status of the execution suspended by CALL or CREATE until the nested call requested
+/// in ExecutionState::suspended_call is done. It is not a valid result of the execution.
+inline constexpr auto suspended_status = static_cast<evmc_status_code>(31);
+
+/// The nested call requested by CALL or CREATE which suspended the execution.
+struct SuspendedCall
+{
+    evmc_message msg{};
+
+    /// Whether the call is requested by CREATE or CREATE2.
+    bool is_create = false;
+
+    /// The memory area for the output of CALL.
+    size_t output_offset = 0;
+    size_t output_size = 0;
+
+    /// The stack height after the call instruction.
+    size_t stack_height = 0;
+
+    /// The instruction following the call instruction, the execution continues from it.
+    /// nullptr if the execution starts from the beginning of the code.
+    const uint8_t* resume_pos = nullptr;
+};
 
 /// Generic execution state for generic instructions implementations.
 // NOLINTNEXTLINE(clang-analyzer-optin.performance.Padding)
@@ -146,7 +269,7 @@ public:
     size_t output_size = 0;
 
     std::size_t call_id;
-    std::vector<nil::evm_assigner::rw_operation<BlueprintFieldType>> rw_trace;
+    nil::evm_assigner::rw_trace_buffer<BlueprintFieldType> rw_trace;
     std::shared_ptr<nil::evm_assigner::assigner<BlueprintFieldType>> assigner;
 
 private:
@@ -162,6 +285,12 @@ public:
 
     std::vector<const uint8_t*> call_stack;
 
+    /// Whether CALL and CREATE suspend the execution with suspended_status instead of
+    /// calling host.call(), so the nested call is executed by the caller of the interpreter.
+    bool suspend_calls = false;
+
+    SuspendedCall suspended_call;
+
     /// Stack space allocation.
     ///
     /// This is the last field to make other fields' offsets of reasonable values.
@@ -182,6 +311,7 @@ public:
     {}
 
     /// Resets the contents of the ExecutionState so that it could be reused.
+    /// Capacities of the memory and the RW trace are kept.
     void reset(const evmc_message& message, evmc_revision revision,
         const evmc_host_interface& host_interface, evmc_host_context* host_ctx, bytes_view _code,
         bytes_view _data) noexcept
@@ -197,6 +327,9 @@ public:
         status = EVMC_SUCCESS;
         output_offset = 0;
         output_size = 0;
+        rw_trace.clear();
+        call_stack.clear();
+        suspended_call = {};
         m_tx = {};
     }
 
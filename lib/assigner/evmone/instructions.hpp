@@ -102,7 +102,11 @@ inline constexpr int64_t copy_cost(uint64_t size_in_bytes) noexcept
 
     gas_left -= cost;
     if (gas_left >= 0) [[likely]]
-        memory.grow(static_cast<size_t>(new_words * word_size));
+    {
+        // Memory which could not be mapped fails the instruction as out of gas
+        if (!memory.grow(static_cast<size_t>(new_words * word_size))) [[unlikely]]
+            return -1;
+    }
     return gas_left;
 }
 
@@ -189,10 +193,52 @@ constexpr auto sstore_costs = []() noexcept {
     return tbl;
 }();
 
+/// Revision of the instantiation which is not known at compile time and is taken from
+/// ExecutionState::rev on execution.
+inline constexpr auto any_revision = static_cast<evmc_revision>(EVMC_MAX_REVISION + 1);
+
 namespace instr::core
 {
-template <typename BlueprintFieldType>
+/// Instruction implementations.
+/// @tparam TracingEnabled  Whether read/write operations are recorded into ExecutionState::rw_trace.
+///                         With false all recording is compiled out, which is useful for
+///                         gas estimation and other dry runs.
+/// @tparam Rev             The EVM revision if it is known at compile time, then checks of the revision
+///                         are constant folded. With any_revision ExecutionState::rev is checked.
+template <typename BlueprintFieldType, bool TracingEnabled, evmc_revision Rev = any_revision>
 struct instructions {
+    /// Returns the revision of the executed code.
+    static evmc_revision revision(const ExecutionState<BlueprintFieldType>& state) noexcept
+    {
+        if constexpr (Rev == any_revision)
+            return state.rev;
+        else
+        {
+            assert(state.rev == Rev);
+            return Rev;
+        }
+    }
+
+    /// Records access to the stack item at index (0 is the top item) into the RW trace.
+    static void trace_stack([[maybe_unused]] StackTop<BlueprintFieldType> stack,
+        [[maybe_unused]] ExecutionState<BlueprintFieldType>& state, [[maybe_unused]] int index,
+        [[maybe_unused]] bool is_write) noexcept
+    {
+        if constexpr (TracingEnabled)
+            state.rw_trace.push_stack(state.call_id,
+                stack.size(state.stack_space.bottom()) - 1 - index, state.rw_trace.size(), is_write, stack[index]);
+    }
+
+    /// Records access to the memory byte into the RW trace.
+    static void trace_memory([[maybe_unused]] ExecutionState<BlueprintFieldType>& state,
+        [[maybe_unused]] const nil::evm_assigner::zkevm_word<BlueprintFieldType>& address,
+        [[maybe_unused]] bool is_write,
+        [[maybe_unused]] const nil::evm_assigner::zkevm_word<BlueprintFieldType>& value) noexcept
+    {
+        if constexpr (TracingEnabled)
+            state.rw_trace.push_memory(state.call_id, address, state.rw_trace.size(), is_write, value);
+    }
+
     /// Check memory requirements of a reasonable size.
     static bool check_memory(
         int64_t& gas_left, Memory& memory, const nil::evm_assigner::zkevm_word<BlueprintFieldType>& offset, uint64_t size) noexcept
@@ -254,117 +300,117 @@ struct instructions {
 
     static void add(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id, stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id, stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         stack.top() = stack.top() + x;// calculate stack next
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id, stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void mul(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         stack.top() = stack.top() * x;
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void sub(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         stack.top() = x - stack.top();
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void div(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         auto& v = stack[0];
         v = v != 0 ? x / v : 0;
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void sdiv(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         auto& v = stack[0];
         v = x.sdiv(v);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void mod(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         auto& v = stack[0];
         v = v != 0 ? x % v : 0;
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void smod(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         auto& v = stack[0];
         v = x.smod(v);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void addmod(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-3, state.rw_trace.size(), false, stack[2]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 2, false);
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         const auto& y = stack.pop();
         auto& m = stack.top();
         m = x.addmod(y, m);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void mulmod(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-3, state.rw_trace.size(), false, stack[2]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 2, false);
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack[0];
         const auto& y = stack[1];
         auto& m = stack[2];
         m = x.mulmod(y, m);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static Result exp(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& base = stack.pop();
         auto& exponent = stack.top();
 
         const unsigned exponent_significant_bytes = exponent.count_significant_bytes();
-        const unsigned exponent_cost = state.rev >= EVMC_SPURIOUS_DRAGON ? 50 : 10;
+        const unsigned exponent_cost = revision(state) >= EVMC_SPURIOUS_DRAGON ? 50 : 10;
         const auto additional_cost = exponent_significant_bytes * exponent_cost;
         if ((gas_left -= additional_cost) < 0)
             return {EVMC_OUT_OF_GAS, gas_left};
 
         exponent = base.exp(exponent);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
         return {EVMC_SUCCESS, gas_left};
     }
 
     static void signextend(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& ext = stack.pop();
         auto& x = stack.top();
 
@@ -394,99 +440,99 @@ struct instructions {
             for (size_t i = 3; i > sign_word_index; --i)
                 x.set_val(sign_ex, i);  // Clear extended words.
         }
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void lt(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         stack[0] = x < stack[0];
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void gt(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         stack[0] = stack[0] < x;  // Arguments are swapped and < is used.
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void slt(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         stack[0] = x.slt(stack[0]);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void sgt(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         stack[0] = stack[0].slt(x);  // Arguments are swapped and SLT is used.
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void eq(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         stack[0] = stack[0] == x;
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void iszero(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 0, false);
         stack.top() = stack.top() == 0;
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void and_(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         stack.top() = stack.top() & x;
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void or_(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         stack.top() = stack.top() | x;
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void xor_(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         stack.top() = stack.top() ^ x;
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void not_(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 0, false);
         stack.top() = ~stack.top();
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void byte(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& n = stack.pop();
         auto& x = stack.top();
 
@@ -498,31 +544,31 @@ struct instructions {
         const auto byte_index = index % 8;
         const auto byte = (word >> (byte_index * 8)) & byte_mask;
         x = nil::evm_assigner::zkevm_word<BlueprintFieldType>(byte);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void shl(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         stack.top() = stack.top() << x;
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void shr(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& x = stack.pop();
         stack.top() = stack.top() >> x;
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void sar(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& y = stack.pop();
         auto& x = stack.top();
 
@@ -531,13 +577,13 @@ struct instructions {
 
         const auto mask_shift = (y < 256) ? (256 - y.to_uint64(0)) : 0;
         x = (x >> y) | (sign_mask << mask_shift);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static Result keccak256(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& index = stack.pop();
         auto& size = stack.top();
 
@@ -555,11 +601,11 @@ struct instructions {
         if (s != 0 ) {
             data = &state.memory[i];
             for(uint64_t j = 0; j < 32; j++){
-                state.rw_trace.push_back(nil::evm_assigner::memory_operation<BlueprintFieldType>(state.call_id,  index + j, state.rw_trace.size(), false, data[j]));
+                trace_memory(state, index + j, false, data[j]);
             }
         }
         size = nil::evm_assigner::zkevm_word<BlueprintFieldType>(ethash::keccak256(data, s));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
         return {EVMC_SUCCESS, gas_left};
     }
 
@@ -567,48 +613,48 @@ struct instructions {
     static void address(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         stack.push(nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.msg->recipient));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static Result balance(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 0, false);
         auto& x = stack.top();
         const auto addr = x.to_address();
 
-        if (state.rev >= EVMC_BERLIN && state.host.access_account(addr) == EVMC_ACCESS_COLD)
+        if (revision(state) >= EVMC_BERLIN && state.host.access_account(addr) == EVMC_ACCESS_COLD)
         {
             if ((gas_left -= instr::additional_cold_account_access_cost) < 0)
                 return {EVMC_OUT_OF_GAS, gas_left};
         }
 
         x = nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.host.get_balance(addr));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
         return {EVMC_SUCCESS, gas_left};
     }
 
     static void origin(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         stack.push(nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.get_tx_context().tx_origin));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void caller(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         stack.push(nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.msg->sender));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void callvalue(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         auto val = nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.msg->value);
         stack.push(val);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void calldataload(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 0, false);
         auto& index = stack.top();
 
         const auto index_uint64 = index.to_uint64();
@@ -625,20 +671,20 @@ struct instructions {
 
             index = nil::evm_assigner::zkevm_word<BlueprintFieldType>(data, 32);
         }
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void calldatasize(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         stack.push(state.msg->input_size);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static Result calldatacopy(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-3, state.rw_trace.size(), false, stack[2]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 2, false);
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& mem_index = stack.pop();
         const auto& input_index = stack.pop();
         const auto& size = stack.pop();
@@ -662,7 +708,7 @@ struct instructions {
             std::memset(&state.memory[dst + copy_size], 0, s - copy_size);
 
         for(uint64_t j = 0; j < copy_size; j++){
-            state.rw_trace.push_back(nil::evm_assigner::memory_operation<BlueprintFieldType>(state.call_id,  mem_index + j, state.rw_trace.size(), true, state.memory[dst + j]));
+            trace_memory(state, mem_index + j, true, state.memory[dst + j]);
         }
 
         return {EVMC_SUCCESS, gas_left};
@@ -671,15 +717,15 @@ struct instructions {
     static void codesize(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         stack.push(state.original_code.size());
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static Result codecopy(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         // TODO: Similar to calldatacopy().
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-3, state.rw_trace.size(), false, stack[2]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 2, false);
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
 
         const auto& mem_index = stack.pop();
         const auto& input_index = stack.pop();
@@ -706,7 +752,7 @@ struct instructions {
             std::memset(&state.memory[dst + copy_size], 0, s - copy_size);
 
         for(uint64_t j = 0; j < copy_size; j++){
-            state.rw_trace.push_back(nil::evm_assigner::memory_operation<BlueprintFieldType>(state.call_id,  mem_index + j, state.rw_trace.size(), true, state.memory[dst + j]));
+            trace_memory(state, mem_index + j, true, state.memory[dst + j]);
         }
 
         return {EVMC_SUCCESS, gas_left};
@@ -716,18 +762,18 @@ struct instructions {
     static void gasprice(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         stack.push(nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.get_tx_context().tx_gas_price));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void basefee(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         stack.push(nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.get_tx_context().block_base_fee));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void blobhash(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 0, false);
         auto& index = stack.top();
         const auto& tx = state.get_tx_context();
         const auto index_uin64 = index.to_uint64();
@@ -735,38 +781,38 @@ struct instructions {
         index = (index_uin64 < tx.blob_hashes_count) ?
                     nil::evm_assigner::zkevm_word<BlueprintFieldType>(tx.blob_hashes[index_uin64]) :
                     0;
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void blobbasefee(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         stack.push(nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.get_tx_context().blob_base_fee));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static Result extcodesize(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 0, false);
         auto& x = stack.top();
         const auto addr = x.to_address();
 
-        if (state.rev >= EVMC_BERLIN && state.host.access_account(addr) == EVMC_ACCESS_COLD)
+        if (revision(state) >= EVMC_BERLIN && state.host.access_account(addr) == EVMC_ACCESS_COLD)
         {
             if ((gas_left -= instr::additional_cold_account_access_cost) < 0)
                 return {EVMC_OUT_OF_GAS, gas_left};
         }
 
         x = state.host.get_code_size(addr);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
         return {EVMC_SUCCESS, gas_left};
     }
 
     static Result extcodecopy(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-4, state.rw_trace.size(), false, stack[3]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-3, state.rw_trace.size(), false, stack[2]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 3, false);
+        trace_stack(stack, state, 2, false);
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto addr = stack.pop().to_address();
         const auto& mem_index = stack.pop();
         const auto& input_index = stack.pop();
@@ -779,7 +825,7 @@ struct instructions {
         if (const auto cost = copy_cost(s); (gas_left -= cost) < 0)
             return {EVMC_OUT_OF_GAS, gas_left};
 
-        if (state.rev >= EVMC_BERLIN && state.host.access_account(addr) == EVMC_ACCESS_COLD)
+        if (revision(state) >= EVMC_BERLIN && state.host.access_account(addr) == EVMC_ACCESS_COLD)
         {
             if ((gas_left -= instr::additional_cold_account_access_cost) < 0)
                 return {EVMC_OUT_OF_GAS, gas_left};
@@ -803,14 +849,14 @@ struct instructions {
     static void returndatasize(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         stack.push(state.return_data.size());
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static Result returndatacopy(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-3, state.rw_trace.size(), false, stack[2]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 2, false);
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& mem_index = stack.pop();
         const auto& input_index = stack.pop();
         const auto& size = stack.pop();
@@ -834,7 +880,7 @@ struct instructions {
         if (s > 0) {
             std::memcpy(&state.memory[dst], &state.return_data[src], s);
             for(uint64_t j = 0; j < s; j++){
-                state.rw_trace.push_back(nil::evm_assigner::memory_operation<BlueprintFieldType>(state.call_id,  dst + j, state.rw_trace.size(), true, state.memory[dst + j]));
+                trace_memory(state, dst + j, true, state.memory[dst + j]);
             }
         }
 
@@ -843,25 +889,25 @@ struct instructions {
 
     static Result extcodehash(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 0, false);
         auto& x = stack.top();
         const auto addr = x.to_address();
 
-        if (state.rev >= EVMC_BERLIN && state.host.access_account(addr) == EVMC_ACCESS_COLD)
+        if (revision(state) >= EVMC_BERLIN && state.host.access_account(addr) == EVMC_ACCESS_COLD)
         {
             if ((gas_left -= instr::additional_cold_account_access_cost) < 0)
                 return {EVMC_OUT_OF_GAS, gas_left};
         }
 
         x = nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.host.get_code_hash(addr));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
         return {EVMC_SUCCESS, gas_left};
     }
 
 
     static void blockhash(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 0, false);
         auto& number = stack.top();
 
         const auto upper_bound = state.get_tx_context().block_number;
@@ -871,58 +917,58 @@ struct instructions {
             (decltype(upper_bound)(n) < upper_bound && decltype(upper_bound)(n) >= lower_bound) ?
             state.host.get_block_hash(decltype(upper_bound)(n)) : evmc::bytes32{};
         number = nil::evm_assigner::zkevm_word<BlueprintFieldType>(header);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void coinbase(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         stack.push(nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.get_tx_context().block_coinbase));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void timestamp(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         // TODO: Add tests for negative timestamp?
         stack.push(static_cast<uint64_t>(state.get_tx_context().block_timestamp));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void number(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         // TODO: Add tests for negative block number?
         stack.push(static_cast<uint64_t>(state.get_tx_context().block_number));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void prevrandao(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         stack.push(nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.get_tx_context().block_prev_randao));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void gaslimit(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         stack.push(static_cast<uint64_t>(state.get_tx_context().block_gas_limit));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void chainid(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         stack.push(nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.get_tx_context().chain_id));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static void selfbalance(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         // TODO: introduce selfbalance in EVMC?
         stack.push(nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.host.get_balance(state.msg->recipient)));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     template<typename T>
     static Result mload(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 0, false);
         auto& index = stack.top();
 
         if (!check_memory(gas_left, state.memory, index, nil::evm_assigner::zkevm_word<BlueprintFieldType>::size))
@@ -931,17 +977,17 @@ struct instructions {
         const auto addr = index.to_uint64();
         index = nil::evm_assigner::zkevm_word<BlueprintFieldType>(&state.memory[addr], nil::evm_assigner::zkevm_word<BlueprintFieldType>::size);
         for(uint64_t j = 0; j < nil::evm_assigner::zkevm_word<BlueprintFieldType>::size; j++){
-            state.rw_trace.push_back(nil::evm_assigner::memory_operation<BlueprintFieldType>(state.call_id,  addr + j, state.rw_trace.size(), false, state.memory[addr + j]));
+            trace_memory(state, addr + j, false, state.memory[addr + j]);
         }
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
         return {EVMC_SUCCESS, gas_left};
     }
 
     template<typename T>
     static Result mstore(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& index = stack.pop();
         auto& value = stack.pop();
 
@@ -951,15 +997,15 @@ struct instructions {
         const auto addr = index.to_uint64();
         value.template store<T>(&state.memory[addr]);
         for(uint64_t j = 0; j < nil::evm_assigner::zkevm_word<BlueprintFieldType>::size; j++){
-            state.rw_trace.push_back(nil::evm_assigner::memory_operation<BlueprintFieldType>(state.call_id,  addr + j, state.rw_trace.size(), true, state.memory[addr + j]));
+            trace_memory(state, addr + j, true, state.memory[addr + j]);
         }
         return {EVMC_SUCCESS, gas_left};
     }
 
     static Result mstore8(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& index = stack.pop();
         const auto& value = stack.pop();
 
@@ -969,7 +1015,7 @@ struct instructions {
         const auto addr = (int)index.to_uint64();
         state.memory[addr] = value.to_uint64();
         for(uint64_t j = 0; j < 8; j++){
-            state.rw_trace.push_back(nil::evm_assigner::memory_operation<BlueprintFieldType>(state.call_id,  addr + j, state.rw_trace.size(), true, state.memory[addr + j]));
+            trace_memory(state, addr + j, true, state.memory[addr + j]);
         }
         return {EVMC_SUCCESS, gas_left};
     }
@@ -991,15 +1037,15 @@ struct instructions {
     /// JUMP instruction implementation using baseline::CodeAnalysis.
     static code_iterator jump(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state, code_iterator /*pos*/) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 0, false);
         return jump_impl(state, stack.pop());
     }
 
     /// JUMPI instruction implementation using baseline::CodeAnalysis.
     static code_iterator jumpi(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state, code_iterator pos) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& dst = stack.pop();
         const auto& cond = stack.pop();
         return cond.to_uint64() > 0 ? jump_impl(state, dst) : pos + 1;
@@ -1014,14 +1060,14 @@ struct instructions {
 
     static code_iterator rjumpi(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state, code_iterator pc) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 0, false);
         const auto cond = stack.pop();
         return cond.to_uint64() > 0 ? rjump(stack, state, pc) : pc + 3;
     }
 
     static code_iterator rjumpv(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state, code_iterator pc) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 0, false);
         constexpr auto REL_OFFSET_SIZE = sizeof(int16_t);
         const auto case_ = stack.pop();
 
@@ -1044,32 +1090,32 @@ struct instructions {
     static code_iterator pc(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state, code_iterator pos) noexcept
     {
         stack.push(static_cast<uint64_t>(pos - state.analysis.baseline->executable_code.data()));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
         return pos + 1;
     }
 
     static void msize(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         stack.push(state.memory.size());
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static Result gas(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         stack.push(gas_left);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
         return {EVMC_SUCCESS, gas_left};
     }
 
     static void tload(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 0, false);
         auto& x = stack.top();
         evmc::bytes32 key = x.to_uint256be();
         const auto value = state.host.get_transient_storage(state.msg->recipient, key);
         // TODO: add trasient storage operations
         x = nil::evm_assigner::zkevm_word<BlueprintFieldType>(value);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static Result tstore(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept
@@ -1077,8 +1123,8 @@ struct instructions {
         if (state.in_static_mode())
             return {EVMC_STATIC_MODE_VIOLATION, 0};
 
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         evmc::bytes32 key = stack.pop().to_uint256be();
         evmc::bytes32 value = stack.pop().to_uint256be();
         state.host.set_transient_storage(state.msg->recipient, key, value);
@@ -1089,7 +1135,7 @@ struct instructions {
     static void push0(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         stack.push({});
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     /// PUSH instruction implementation.
@@ -1098,18 +1144,24 @@ struct instructions {
     /// It assumes that at lest 32 bytes of data are available so code padding is required.
     template <size_t Len>
     static code_iterator push(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state, code_iterator pos) noexcept
+    {
+        stack.push(0);
+        load_push_data(stack.top(), pos + 1, Len);
+        trace_push(stack, state);
+
+        return pos + (Len + 1);
+    }
+
+    /// Loads len bytes of push data into the zero word r.
+    static void load_push_data(nil::evm_assigner::zkevm_word<BlueprintFieldType>& r, code_iterator data, size_t len) noexcept
     {
         // TODO size of field in bytes
         constexpr size_t word_size = 8;
-        constexpr auto num_full_words = Len / word_size;
-        constexpr auto num_partial_bytes = Len % word_size;
-        auto data = pos + 1;
-
-        stack.push(0);
-        auto& r = stack.top();
+        const auto num_full_words = len / word_size;
+        const auto num_partial_bytes = len % word_size;
 
         // Load top partial word.
-        if constexpr (num_partial_bytes != 0)
+        if (num_partial_bytes != 0)
         {
             r.load_partial_data(data, num_partial_bytes, num_full_words);
             data += num_partial_bytes;
@@ -1121,13 +1173,12 @@ struct instructions {
             r.load_partial_data(data, word_size, num_full_words - 1 - i);
             data += word_size;
         }
+    }
 
-        int num_words = (int)(Len / nil::evm_assigner::zkevm_word<BlueprintFieldType>::size) + (int)(Len % nil::evm_assigner::zkevm_word<BlueprintFieldType>::size);
-        for (int i = 0; i < num_words; ++i) {
-            state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  (uint16_t)(stack.size(state.stack_space.bottom())- 1 - i), state.rw_trace.size(), true, stack[i]));
-        }
-
-        return pos + (Len + 1);
+    /// Records the stack write of PUSH instruction, the push data of any length is one stack item.
+    static void trace_push(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
+    {
+        trace_stack(stack, state, 0, true);
     }
 
     /// DUP instruction implementation.
@@ -1138,19 +1189,19 @@ struct instructions {
         static_assert(N >= 0 && N <= 16);
         if constexpr (N == 0)
         {
-            state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+            trace_stack(stack, state, 0, false);
             const auto index = stack.pop();
             const auto addr = (int)index.to_uint64();
             assert(addr < std::numeric_limits<int>::max());
-            state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  (uint16_t)(stack.size(state.stack_space.bottom()) - addr), state.rw_trace.size(), false, stack[addr - 1]));
+            trace_stack(stack, state, addr - 1, false);
             stack.push(stack[addr - 1]);
-            state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())- 1, state.rw_trace.size(), true, stack[0]));
+            trace_stack(stack, state, 0, true);
         }
         else
         {
-            state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom()) - N, state.rw_trace.size(), false, stack[N - 1]));
+            trace_stack(stack, state, N - 1, false);
             stack.push(stack[N - 1]);
-            state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())- 1, state.rw_trace.size(), true, stack[0]));
+            trace_stack(stack, state, 0, true);
         }
     }
 
@@ -1168,7 +1219,7 @@ struct instructions {
         uint16_t addr = N;
         if constexpr (N == 0)
         {
-            state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+            trace_stack(stack, state, 0, false);
             auto& index = stack.pop();
             assert(index < std::numeric_limits<int>::max());
             addr = (uint16_t)index.to_uint64();
@@ -1178,8 +1229,8 @@ struct instructions {
         {
             a = &stack[N];
         }
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  (uint16_t)(stack.size(state.stack_space.bottom()) - addr - 1), state.rw_trace.size(), false, stack[addr]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())-1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, addr, false);
+        trace_stack(stack, state, 0, false);
         auto& t = stack.top();
         auto t0 = t.to_uint64(0);
         auto t1 = t.to_uint64(1);
@@ -1190,8 +1241,8 @@ struct instructions {
         a->set_val(t1, 1);
         a->set_val(t2, 2);
         a->set_val(t3, 3);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())- 1, state.rw_trace.size(), true, stack[0]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  (uint16_t)(stack.size(state.stack_space.bottom()) - addr), state.rw_trace.size(), true, stack[addr - 1]));
+        trace_stack(stack, state, 0, true);
+        trace_stack(stack, state, addr - 1, true);
     }
 
     static code_iterator dupn(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state, code_iterator pos) noexcept
@@ -1206,9 +1257,9 @@ struct instructions {
             return nullptr;
         }
 
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  (uint16_t)(stack.size(state.stack_space.bottom()) - n), state.rw_trace.size(), false, stack[n - 1]));
+        trace_stack(stack, state, n - 1, false);
         stack.push(stack[n - 1]);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())- 1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
 
         return pos + 2;
     }
@@ -1225,21 +1276,21 @@ struct instructions {
             return nullptr;
         }
 
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  (uint16_t)(stack.size(state.stack_space.bottom()) - n - 1), state.rw_trace.size(), false, stack[n]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom()) - 1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, n, false);
+        trace_stack(stack, state, 0, false);
         // TODO: This may not be optimal, see instr::core::swap().
         std::swap(stack.top(), stack[n]);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom())- 1, state.rw_trace.size(), true, stack[0]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  (uint16_t)(stack.size(state.stack_space.bottom()) - n - 1), state.rw_trace.size(), true, stack[n]));
+        trace_stack(stack, state, 0, true);
+        trace_stack(stack, state, n, true);
 
         return pos + 2;
     }
 
     static Result mcopy(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom()) - 3, state.rw_trace.size(), false, stack[2]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom()) - 2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom()) - 1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 2, false);
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& dst_u256 = stack.pop();
         const auto& src_u256 = stack.pop();
         const auto& size_u256 = stack.pop();
@@ -1259,8 +1310,8 @@ struct instructions {
             // TODO: add length read operations to memory
             // TODO: add length write operations to memory
             /*for(uint64_t j = 0; j < size; j++){
-                state.rw_trace.push_back(nil::evm_assigner::memory_operation<BlueprintFieldType>(state.call_id,  src + j, state.rw_trace.size(), false, state.memory[src + j]));
-                state.rw_trace.push_back(nil::evm_assigner::memory_operation<BlueprintFieldType>(state.call_id,  dst + j, state.rw_trace.size(), true, state.memory[dst + j]));
+                trace_memory(state, src + j, false, state.memory[src + j]);
+                trace_memory(state, dst + j, true, state.memory[dst + j]);
             }*/
         }
 
@@ -1269,7 +1320,7 @@ struct instructions {
 
     static void dataload(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom()) - 1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 0, false);
         auto& index = stack.top();
 
         if (state.data.size() < index.to_uint64())
@@ -1284,14 +1335,14 @@ struct instructions {
                 data[i] = state.data[begin + i];
 
             index = nil::evm_assigner::zkevm_word<BlueprintFieldType>(data, (end - begin));
-            state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom()) - 1, state.rw_trace.size(), true, stack[0]));
+            trace_stack(stack, state, 0, true);
         }
     }
 
     static void datasize(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state) noexcept
     {
         stack.push(state.data.size());
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom()) - 1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
     }
 
     static code_iterator dataloadn(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state, code_iterator pos) noexcept
@@ -1299,15 +1350,15 @@ struct instructions {
         const auto index = read_uint16_be(&pos[1]);
 
         stack.push(nil::evm_assigner::zkevm_word<BlueprintFieldType>(&state.data[index], nil::evm_assigner::zkevm_word<BlueprintFieldType>::size));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom()) - 1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
         return pos + 3;
     }
 
     static Result datacopy(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom()) - 3, state.rw_trace.size(), false, stack[2]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom()) - 2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom()) - 1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 2, false);
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& mem_index = stack.pop();
         const auto& data_index = stack.pop();
         const auto& size = stack.pop();
@@ -1329,14 +1380,14 @@ struct instructions {
         if (copy_size > 0) {
             std::memcpy(&state.memory[dst], &state.data[src], copy_size);
             for(uint64_t j = 0; j < copy_size; j++){
-                state.rw_trace.push_back(nil::evm_assigner::memory_operation<BlueprintFieldType>(state.call_id,  dst + j, state.rw_trace.size(), true, state.memory[dst + j]));
+                trace_memory(state, dst + j, true, state.memory[dst + j]);
             }
         }
 
         if (s - copy_size > 0) {
             std::memset(&state.memory[dst + copy_size], 0, s - copy_size);
             for(uint64_t j = 0; j < s - copy_size; j++){
-                state.rw_trace.push_back(nil::evm_assigner::memory_operation<BlueprintFieldType>(state.call_id,  dst + j, state.rw_trace.size(), true, 0));
+                trace_memory(state, dst + j, true, 0);
             }
         }
 
@@ -1349,7 +1400,7 @@ struct instructions {
 
         uint16_t num_stack_read = (Op == OP_STATICCALL || Op == OP_DELEGATECALL) ? 6 : 7;
         for (uint16_t i = 0; i < num_stack_read; i++) {
-            state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  (uint16_t)(stack.size(state.stack_space.bottom()) - (i + 1)), state.rw_trace.size(), false, stack[i]));
+            trace_stack(stack, state, i, false);
         }
         const auto gas = stack.pop();
         const auto dst = stack.pop().to_address();
@@ -1363,7 +1414,7 @@ struct instructions {
         stack.push(0);  // Assume failure.
         state.return_data.clear();
 
-        if (state.rev >= EVMC_BERLIN && state.host.access_account(dst) == EVMC_ACCESS_COLD)
+        if (revision(state) >= EVMC_BERLIN && state.host.access_account(dst) == EVMC_ACCESS_COLD)
         {
             if ((gas_left -= instr::additional_cold_account_access_cost) < 0)
                 return {EVMC_OUT_OF_GAS, gas_left};
@@ -1406,7 +1457,7 @@ struct instructions {
             if (has_value && state.in_static_mode())
                 return {EVMC_STATIC_MODE_VIOLATION, gas_left};
 
-            if ((has_value || state.rev < EVMC_SPURIOUS_DRAGON) && !state.host.account_exists(dst))
+            if ((has_value || revision(state) < EVMC_SPURIOUS_DRAGON) && !state.host.account_exists(dst))
                 cost += 25000;
         }
 
@@ -1418,7 +1469,7 @@ struct instructions {
         if (gas_int64 < msg.gas)
             msg.gas = gas_int64;
 
-        if (state.rev >= EVMC_TANGERINE_WHISTLE)  // TODO: Always true for STATICCALL.
+        if (revision(state) >= EVMC_TANGERINE_WHISTLE)  // TODO: Always true for STATICCALL.
             msg.gas = std::min(msg.gas, gas_left - gas_left / 64);
         else if (msg.gas > gas_left)
             return {EVMC_OUT_OF_GAS, gas_left};
@@ -1437,7 +1488,7 @@ struct instructions {
 
         if (Op == OP_DELEGATECALL)
         {
-            if (state.rev >= EVMC_PRAGUE && is_eof_container(state.original_code))
+            if (revision(state) >= EVMC_PRAGUE && is_eof_container(state.original_code))
             {
                 // The code targeted by DELEGATECALL must also be an EOF.
                 // This restriction has been added to EIP-3540 in
@@ -1450,18 +1501,31 @@ struct instructions {
             }
         }
 
+        if (state.suspend_calls)
+        {
+            state.suspended_call = {msg, false, output_offset, output_size, stack.size(state.stack_space.bottom())};
+            return {suspended_status, gas_left - msg.gas};
+        }
+
         const auto result = state.host.call(msg);
+        return {EVMC_SUCCESS, complete_call(stack, state, result, output_offset, output_size, gas_left - msg.gas)};
+    }
+
+    /// Puts the result of the nested call of CALL, CALLCODE, DELEGATECALL or STATICCALL
+    /// onto the stack and into the memory.
+    /// @return  Gas left, gas_left is the gas without the gas passed to the nested call.
+    static int64_t complete_call(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state,
+        const evmc::Result& result, size_t output_offset, size_t output_size, int64_t gas_left) noexcept
+    {
         state.return_data.assign(result.output_data, result.output_size);
         stack.top() = result.status_code == EVMC_SUCCESS;
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom()) - 1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
 
         if (const auto copy_size = std::min(output_size, result.output_size); copy_size > 0)
             std::memcpy(&state.memory[output_offset], result.output_data, copy_size);
 
-        const auto gas_used = msg.gas - result.gas_left;
-        gas_left -= gas_used;
         state.gas_refund += result.gas_refund;
-        return {EVMC_SUCCESS, gas_left};
+        return gas_left + result.gas_left;
     }
 
     static Result call(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept {
@@ -1488,7 +1552,7 @@ struct instructions {
 
         uint16_t num_stack_read = (Op == OP_CREATE2) ? 4 : 3;
         for (uint16_t i = 0; i < num_stack_read; i++) {
-            state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  (uint16_t)(stack.size(state.stack_space.bottom()) - (i + 1)), state.rw_trace.size(), false, stack[i]));
+            trace_stack(stack, state, i, false);
         }
         const auto endowment = stack.pop();
         const auto init_code_offset_u256 = stack.pop();
@@ -1504,10 +1568,10 @@ struct instructions {
         const auto init_code_offset = init_code_offset_u256.to_uint64();
         const auto init_code_size = init_code_size_u256.to_uint64();
 
-        if (state.rev >= EVMC_SHANGHAI && init_code_size > 0xC000)
+        if (revision(state) >= EVMC_SHANGHAI && init_code_size > 0xC000)
             return {EVMC_OUT_OF_GAS, gas_left};
 
-        const auto init_code_word_cost = 6 * (Op == OP_CREATE2) + 2 * (state.rev >= EVMC_SHANGHAI);
+        const auto init_code_word_cost = 6 * (Op == OP_CREATE2) + 2 * (revision(state) >= EVMC_SHANGHAI);
         const auto init_code_cost = num_words(init_code_size) * init_code_word_cost;
         if ((gas_left -= init_code_cost) < 0)
             return {EVMC_OUT_OF_GAS, gas_left};
@@ -1521,7 +1585,7 @@ struct instructions {
 
         auto msg = evmc_message{};
         msg.gas = gas_left;
-        if (state.rev >= EVMC_TANGERINE_WHISTLE)
+        if (revision(state) >= EVMC_TANGERINE_WHISTLE)
             msg.gas = msg.gas - msg.gas / 64;
 
         msg.kind = (Op == OP_CREATE) ? EVMC_CREATE : EVMC_CREATE2;
@@ -1536,16 +1600,45 @@ struct instructions {
         msg.create2_salt = salt.to_uint256be();
         msg.value = endowment.to_uint256be();
 
+        if (state.suspend_calls)
+        {
+            state.suspended_call = {msg, true, 0, 0, stack.size(state.stack_space.bottom())};
+            return {suspended_status, gas_left - msg.gas};
+        }
+
         const auto result = state.host.call(msg);
-        gas_left -= msg.gas - result.gas_left;
+        return {EVMC_SUCCESS, complete_create(stack, state, result, gas_left - msg.gas)};
+    }
+
+    /// Puts the address created by the nested call of CREATE or CREATE2 onto the stack.
+    /// @return  Gas left, gas_left is the gas without the gas passed to the nested call.
+    static int64_t complete_create(StackTop<BlueprintFieldType> stack, ExecutionState<BlueprintFieldType>& state,
+        const evmc::Result& result, int64_t gas_left) noexcept
+    {
         state.gas_refund += result.gas_refund;
 
         state.return_data.assign(result.output_data, result.output_size);
         if (result.status_code == EVMC_SUCCESS)
             stack.top() = nil::evm_assigner::zkevm_word<BlueprintFieldType>(result.create_address);
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id,  stack.size(state.stack_space.bottom()) - 1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
 
-        return {EVMC_SUCCESS, gas_left};
+        return gas_left + result.gas_left;
+    }
+
+    /// Completes CALL or CREATE which suspended the execution with the result of the nested call,
+    /// the execution continues from state.suspended_call.resume_pos.
+    /// @param gas_left  Gas left returned by the interpreter when the execution was suspended.
+    /// @return  Gas left for the continued execution.
+    static int64_t resume_call(ExecutionState<BlueprintFieldType>& state, const evmc::Result& result,
+        int64_t gas_left) noexcept
+    {
+        const auto& call = state.suspended_call;
+        assert(state.status == suspended_status && call.resume_pos != nullptr);
+        state.status = EVMC_SUCCESS;
+        StackTop<BlueprintFieldType> stack{state.stack_space.bottom() + call.stack_height};
+        return call.is_create ?
+                   complete_create(stack, state, result, gas_left) :
+                   complete_call(stack, state, result, call.output_offset, call.output_size, gas_left);
     }
 
     static Result create(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept {
@@ -1611,8 +1704,8 @@ struct instructions {
 
     static TermResult return_impl(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state, evmc_status_code StatusCode) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id, stack.size(state.stack_space.bottom()) - 2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id, stack.size(state.stack_space.bottom()) - 1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto& offset = stack[0];
         const auto& size = stack[1];
 
@@ -1637,18 +1730,18 @@ struct instructions {
         if (state.in_static_mode())
             return {EVMC_STATIC_MODE_VIOLATION, gas_left};
 
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id, stack.size(state.stack_space.bottom()) - 1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 0, false);
         const auto beneficiary = stack[0].to_address();
 
-        if (state.rev >= EVMC_BERLIN && state.host.access_account(beneficiary) == EVMC_ACCESS_COLD)
+        if (revision(state) >= EVMC_BERLIN && state.host.access_account(beneficiary) == EVMC_ACCESS_COLD)
         {
             if ((gas_left -= instr::cold_account_access_cost) < 0)
                 return {EVMC_OUT_OF_GAS, gas_left};
         }
 
-        if (state.rev >= EVMC_TANGERINE_WHISTLE)
+        if (revision(state) >= EVMC_TANGERINE_WHISTLE)
         {
-            if (state.rev == EVMC_TANGERINE_WHISTLE || state.host.get_balance(state.msg->recipient))
+            if (revision(state) == EVMC_TANGERINE_WHISTLE || state.host.get_balance(state.msg->recipient))
             {
                 // After TANGERINE_WHISTLE apply additional cost of
                 // sending value to a non-existing account.
@@ -1662,7 +1755,7 @@ struct instructions {
 
         if (state.host.selfdestruct(state.msg->recipient, beneficiary))
         {
-            if (state.rev < EVMC_LONDON)
+            if (revision(state) < EVMC_LONDON)
                 state.gas_refund += 24000;
         }
         return {EVMC_SUCCESS, gas_left};
@@ -1670,11 +1763,11 @@ struct instructions {
 
     static Result sload(StackTop<BlueprintFieldType> stack, int64_t gas_left, ExecutionState<BlueprintFieldType>& state) noexcept
     {
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id, stack.size(state.stack_space.bottom()) - 1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 0, false);
         auto& x = stack.top();
         const auto key = x.to_uint256be();
 
-        if (state.rev >= EVMC_BERLIN &&
+        if (revision(state) >= EVMC_BERLIN &&
             state.host.access_storage(state.msg->recipient, key) == EVMC_ACCESS_COLD)
         {
             // The warm storage access cost is already applied (from the cost table).
@@ -1686,17 +1779,18 @@ struct instructions {
         }
 
         const auto value = nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.host.get_storage(state.msg->recipient, key));
-        state.rw_trace.push_back(storage_operation<BlueprintFieldType>(
-                        state.call_id,
-                        nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.msg->recipient),// should be transaction_id), WHY???
-                        x,
-                        state.rw_trace.size(),
-                        false,
-                        value,
-                        value
-                    ));
+        if constexpr (TracingEnabled)
+            state.rw_trace.push_back(storage_operation<BlueprintFieldType>(
+                            state.call_id,
+                            nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.msg->recipient),// should be transaction_id), WHY???
+                            x,
+                            state.rw_trace.size(),
+                            false,
+                            value,
+                            value
+                        ));
         x = value;
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id, stack.size(state.stack_space.bottom()) - 1, state.rw_trace.size(), true, stack[0]));
+        trace_stack(stack, state, 0, true);
 
         return {EVMC_SUCCESS, gas_left};
     }
@@ -1706,33 +1800,35 @@ struct instructions {
         if (state.in_static_mode())
             return {EVMC_STATIC_MODE_VIOLATION, gas_left};
 
-        if (state.rev >= EVMC_ISTANBUL && gas_left <= 2300)
+        if (revision(state) >= EVMC_ISTANBUL && gas_left <= 2300)
             return {EVMC_OUT_OF_GAS, gas_left};
 
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id, stack.size(state.stack_space.bottom()) - 2, state.rw_trace.size(), false, stack[1]));
-        state.rw_trace.push_back(stack_operation<BlueprintFieldType>(state.call_id, stack.size(state.stack_space.bottom()) - 1, state.rw_trace.size(), false, stack[0]));
+        trace_stack(stack, state, 1, false);
+        trace_stack(stack, state, 0, false);
         const auto key = stack.pop();
         const auto value = stack.pop();
         const auto key_uint64 = key.to_uint256be();
         const auto value_uint64 = value.to_uint256be();
 
         const auto gas_cost_cold =
-            (state.rev >= EVMC_BERLIN &&
+            (revision(state) >= EVMC_BERLIN &&
                 state.host.access_storage(state.msg->recipient, key_uint64) == EVMC_ACCESS_COLD) ?
                 instr::cold_sload_cost :
                 0;
-        state.rw_trace.push_back(storage_operation<BlueprintFieldType>(
-                        state.call_id,//TODO should be transaction_id)
-                        nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.msg->recipient),
-                        key,
-                        state.rw_trace.size(),
-                        true,
-                        value,
-                        state.host.get_storage(state.msg->recipient, key_uint64)
-                    ));
+        // Previous value is requested from the host only when it is recorded.
+        if constexpr (TracingEnabled)
+            state.rw_trace.push_back(storage_operation<BlueprintFieldType>(
+                            state.call_id,//TODO should be transaction_id)
+                            nil::evm_assigner::zkevm_word<BlueprintFieldType>(state.msg->recipient),
+                            key,
+                            state.rw_trace.size(),
+                            true,
+                            value,
+                            state.host.get_storage(state.msg->recipient, key_uint64)
+                        ));
         const auto status = state.host.set_storage(state.msg->recipient, key_uint64, value_uint64);
 
-        const auto [gas_cost_warm, gas_refund] = sstore_costs[state.rev][status];
+        const auto [gas_cost_warm, gas_refund] = sstore_costs[revision(state)][status];
         const auto gas_cost = gas_cost_warm + gas_cost_cold;
         if ((gas_left -= gas_cost) < 0)
             return {EVMC_OUT_OF_GAS, gas_left};
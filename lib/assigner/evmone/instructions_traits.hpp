@@ -5,6 +5,7 @@
 
 #include "instructions_opcodes.hpp"
 #include <array>
+#include <initializer_list>
 #include <optional>
 
 namespace evmone::instr
@@ -432,4 +433,19 @@ constexpr inline std::array<Traits, 256> traits = []() noexcept {
     return table;
 }();
 
+/// The table of instructions which implementations receive the gas counter: they have
+/// additional dynamic gas cost, inspect the gas left or terminate the execution.
+/// Basic blocks end before such instructions and they are checked individually.
+constexpr inline std::array<bool, 256> uses_gas_counter = []() noexcept {
+    std::array<bool, 256> table{};
+    for (const auto op : {OP_STOP, OP_EXP, OP_KECCAK256, OP_BALANCE, OP_CALLDATACOPY, OP_CODECOPY,
+             OP_EXTCODESIZE, OP_EXTCODECOPY, OP_RETURNDATACOPY, OP_EXTCODEHASH, OP_MLOAD,
+             OP_MLOAD8, OP_MLOAD16, OP_MLOAD32, OP_MLOAD64, OP_MSTORE, OP_MSTORE8, OP_MSTORE16,
+             OP_MSTORE32, OP_MSTORE64, OP_SLOAD, OP_SSTORE, OP_GAS, OP_TSTORE, OP_MCOPY,
+             OP_DATACOPY, OP_CREATE, OP_CALL, OP_CALLCODE, OP_RETURN, OP_DELEGATECALL, OP_CREATE2,
+             OP_STATICCALL, OP_REVERT, OP_INVALID, OP_SELFDESTRUCT})
+        table[op] = true;
+    return table;
+}();
+
 }  // namespace evmone::instr
@@ -0,0 +1,152 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) Nil Foundation and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------//
+
+#ifndef EVM_ASSIGNER_LIB_ASSIGNER_INCLUDE_ANALYSIS_CACHE_HPP_
+#define EVM_ASSIGNER_LIB_ASSIGNER_INCLUDE_ANALYSIS_CACHE_HPP_
+
+#include <evmc.hpp>
+#include <ethash/keccak.hpp>
+
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include <baseline.hpp>
+#include <eof.hpp>
+
+namespace nil {
+    namespace evm_assigner {
+
+        /// Hasher of keccak256 digests for unordered containers, digest is already uniformly distributed
+        struct hash256_hasher {
+            std::size_t operator()(const ethash::hash256& hash) const {
+                return static_cast<std::size_t>(hash.word64s[0]);
+            }
+        };
+
+        struct hash256_equal {
+            bool operator()(const ethash::hash256& lhs, const ethash::hash256& rhs) const {
+                return std::memcmp(lhs.bytes, rhs.bytes, sizeof(lhs.bytes)) == 0;
+            }
+        };
+
+        /// Analysis of the code together with its keccak256 hash
+        struct code_entry {
+            evmone::baseline::CodeAnalysis analysis;
+            /// Not set for the code which is not cached
+            std::optional<ethash::hash256> code_hash;
+        };
+
+        /// Thread-safe LRU cache of code analyses keyed by code hash and revision.
+        /// Only legacy code is cached, analysis of EOF container refers to the container memory.
+        class analysis_cache {
+        public:
+            using entry_ptr = std::shared_ptr<const code_entry>;
+
+            static constexpr std::size_t default_capacity = 1024;
+
+            explicit analysis_cache(std::size_t capacity = default_capacity) : m_capacity(capacity) {}
+
+            analysis_cache(const analysis_cache&) = delete;
+            analysis_cache& operator=(const analysis_cache&) = delete;
+
+            /// Returns cached analysis of the code or analyzes it.
+            /// Returned entry stays valid after it is evicted from the cache.
+            entry_ptr get(evmc_revision rev, evmone::bytes_view code) {
+                if (m_capacity == 0 || (rev >= EVMC_PRAGUE && evmone::is_eof_container(code))) {
+                    return std::make_shared<const code_entry>(code_entry{evmone::baseline::analyze(rev, code), std::nullopt});
+                }
+
+                const cache_key key{ethash::keccak256(code.data(), code.size()), rev};
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    const auto it = m_index.find(key);
+                    if (it != m_index.end()) {
+                        m_hits++;
+                        m_entries.splice(m_entries.begin(), m_entries, it->second);
+                        return it->second->second;
+                    }
+                    m_misses++;
+                }
+
+                // Analysis is done without the lock, the code could be analyzed by several threads at once
+                auto entry = std::make_shared<const code_entry>(code_entry{evmone::baseline::analyze(rev, code), key.hash});
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                const auto it = m_index.find(key);
+                if (it != m_index.end()) {
+                    m_entries.splice(m_entries.begin(), m_entries, it->second);
+                    return it->second->second;
+                }
+                m_entries.emplace_front(key, entry);
+                m_index.emplace(key, m_entries.begin());
+                if (m_entries.size() > m_capacity) {
+                    m_index.erase(m_entries.back().first);
+                    m_entries.pop_back();
+                }
+                return entry;
+            }
+
+            std::size_t hits() const {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_hits;
+            }
+
+            std::size_t misses() const {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_misses;
+            }
+
+            std::size_t size() const {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_entries.size();
+            }
+
+            std::size_t capacity() const {
+                return m_capacity;
+            }
+
+            void clear() {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_index.clear();
+                m_entries.clear();
+                m_hits = 0;
+                m_misses = 0;
+            }
+
+        private:
+            struct cache_key {
+                ethash::hash256 hash;
+                evmc_revision rev;
+
+                bool operator==(const cache_key& other) const {
+                    return rev == other.rev && hash256_equal{}(hash, other.hash);
+                }
+            };
+
+            struct cache_key_hash {
+                std::size_t operator()(const cache_key& key) const {
+                    return hash256_hasher{}(key.hash) ^ static_cast<std::size_t>(key.rev);
+                }
+            };
+
+            using entries_list = std::list<std::pair<cache_key, entry_ptr>>;
+
+            const std::size_t m_capacity;
+            mutable std::mutex m_mutex;
+            entries_list m_entries;    // most recently used first
+            std::unordered_map<cache_key, entries_list::iterator, cache_key_hash> m_index;
+            std::size_t m_hits = 0;
+            std::size_t m_misses = 0;
+        };
+    }     // namespace evm_assigner
+}    // namespace nil
+
+#endif    // EVM_ASSIGNER_LIB_ASSIGNER_INCLUDE_ANALYSIS_CACHE_HPP_
@@ -9,6 +9,12 @@
 #define EVM_ASSIGNER_LIB_ASSIGNER_INCLUDE_ASSIGNER_HPP_
 
 #include <evmc.hpp>
+#include <ethash/keccak.hpp>
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 #include <boost/log/core.hpp>
 #include <boost/log/expressions.hpp>
@@ -17,7 +23,9 @@
 #include <nil/crypto3/algebra/curves/pallas.hpp>
 #include <nil/blueprint/blueprint/plonk/assignment.hpp>
 
+#include <analysis_cache.hpp>
 #include <bytecode.hpp>
+#include <parallel.hpp>
 #include <baseline.hpp>
 #include <execution_state.hpp>
 #include <rw.hpp>
@@ -37,6 +45,97 @@ namespace nil {
             {"rw", zkevm_circuit::RW}
         };
 
+        /// Call executed by evaluate() in its own frame
+        struct nested_call {
+            /// Message of the frame, CREATE executes the init code as a call of the new account
+            evmc_message msg{};
+            evmone::bytes_view code;
+            evmc_revision rev{};
+            /// Whether the frame executes the init code of CREATE or CREATE2
+            bool is_create = false;
+        };
+
+        /// Host which lets evaluate() execute nested calls on its own stack of frames
+        /// instead of recursing through evmc::Host::call()
+        class nested_call_handler {
+        public:
+            virtual ~nested_call_handler() = default;
+
+            /// Prepares the call requested by CALL or CREATE, e.g. transfers the value and creates the account.
+            /// @return  The result if the call does not execute any code, otherwise call is filled
+            virtual std::optional<evmc::Result> begin_call(const evmc_message& msg, nested_call& call) = 0;
+
+            /// Completes the call when its frame is done, e.g. stores the code of the created account
+            virtual void end_call(const nested_call& call, evmc::Result& result) = 0;
+        };
+
+        /// Frame of the call stack of evaluate(), allocated on the heap with its EVM stack
+        template<typename BlueprintFieldType>
+        struct call_frame {
+            /// Prepares the frame for the call, the memory and RW trace buffers of the previous call are kept
+            void reset(const nested_call& _call, analysis_cache::entry_ptr _code_entry,
+                       const evmc_host_interface& host, evmc_host_context* ctx,
+                       std::shared_ptr<nil::evm_assigner::assigner<BlueprintFieldType>> assigner) {
+                call = _call;
+                code_entry = std::move(_code_entry);
+                state.reset(call.msg, call.rev, host, ctx, call.code, code_entry->analysis.eof_header.get_data(call.code));
+                state.call_id = 0;
+                state.assigner = std::move(assigner);
+                state.analysis.baseline = &code_entry->analysis;  // Assign code analysis for instruction implementations.
+                gas = call.msg.gas;
+            }
+
+            /// Drops references to the code analysis and the assigner when the call is done
+            void release() {
+                code_entry.reset();
+                state.assigner.reset();
+            }
+
+            nested_call call;
+            analysis_cache::entry_ptr code_entry;
+            evmone::ExecutionState<BlueprintFieldType> state;
+            int64_t gas = 0;
+        };
+
+        /// Frames of evaluate() reused by call depth, so re-entering a depth does not allocate
+        template<typename BlueprintFieldType>
+        class call_frame_pool {
+        public:
+            /// Returns the frame of the call depth prepared for the call
+            call_frame<BlueprintFieldType>& acquire(const nested_call& call, analysis_cache::entry_ptr code_entry,
+                                                    const evmc_host_interface& host, evmc_host_context* ctx,
+                                                    std::shared_ptr<nil::evm_assigner::assigner<BlueprintFieldType>> assigner) {
+                const auto depth = static_cast<std::size_t>(call.msg.depth);
+                if (depth >= m_frames.size()) {
+                    m_frames.resize(depth + 1);
+                }
+                auto& frame = m_frames[depth];
+                if (!frame) {
+                    frame = std::make_unique<call_frame<BlueprintFieldType>>();
+                }
+                frame->reset(call, std::move(code_entry), host, ctx, std::move(assigner));
+                return *frame;
+            }
+
+            /// Returns the frame of the call depth
+            call_frame<BlueprintFieldType>& operator[](std::size_t depth) {
+                return *m_frames[depth];
+            }
+
+            /// Number of depths with allocated frames
+            std::size_t size() const {
+                return m_frames.size();
+            }
+
+            /// Frees all frames
+            void clear() {
+                m_frames.clear();
+            }
+
+        private:
+            std::vector<std::unique_ptr<call_frame<BlueprintFieldType>>> m_frames;
+        };
+
         template<typename BlueprintFieldType>
         struct assigner {
 
@@ -45,68 +144,147 @@ namespace nil {
             constexpr static size_t BYTECODE_TABLE_INDEX = 0;
             constexpr static size_t RW_TABLE_INDEX = 1;
 
-            assigner(std::vector<nil::blueprint::assignment<ArithmetizationType>> &assignments):  m_assignments(assignments) {}
+            /// @param threads_amount  Number of threads used for filling assignment tables
+            /// @param analysis_cache_capacity  Number of code analyses kept between calls, 0 disables caching
+            assigner(std::vector<nil::blueprint::assignment<ArithmetizationType>> &assignments,
+                     std::size_t threads_amount = default_threads_amount(),
+                     std::size_t analysis_cache_capacity = analysis_cache::default_capacity):
+                m_assignments(assignments), m_threads_amount(threads_amount), m_analysis_cache(analysis_cache_capacity) {}
 
             // TODO error handling
             void handle_bytecode(size_t original_code_size, const uint8_t* code) {
-                return process_bytecode_input<BlueprintFieldType>(
-                    original_code_size, code, m_assignments[BYTECODE_TABLE_INDEX]);
+                handle_bytecode(original_code_size, code, ethash::keccak256(code, original_code_size));
+            }
+
+            /// Code is added to the bytecode table only once per block
+            // TODO error handling
+            void handle_bytecode(size_t original_code_size, const uint8_t* code, const ethash::hash256& code_hash) {
+                if (m_bytecode_start_rows.find(code_hash) != m_bytecode_start_rows.end()) {
+                    return;
+                }
+                const auto start_row = process_bytecode_input<BlueprintFieldType>(
+                    original_code_size, code, code_hash, m_assignments[BYTECODE_TABLE_INDEX], m_threads_amount);
+                m_bytecode_start_rows.emplace(code_hash, start_row);
+            }
+
+            /// Starts new block, the code executed after it is added to the bytecode table again
+            void start_block() {
+                m_bytecode_start_rows.clear();
+            }
+
+            /// Returns the row of the bytecode table where the code starts
+            /// if it was added in the current block
+            std::optional<std::size_t> bytecode_start_row(const ethash::hash256& code_hash) const {
+                const auto it = m_bytecode_start_rows.find(code_hash);
+                if (it == m_bytecode_start_rows.end()) {
+                    return std::nullopt;
+                }
+                return it->second;
             }
 
             // TODO error handling
-            void handle_rw(std::vector<rw_operation<BlueprintFieldType>>& rw_trace) {
+            void handle_rw(const rw_trace_buffer<BlueprintFieldType>& rw_trace) {
                 return process_rw_operations<BlueprintFieldType>(
-                    rw_trace, m_assignments[RW_TABLE_INDEX]);
+                    rw_trace, m_assignments[RW_TABLE_INDEX], m_threads_amount);
             }
 
             std::vector<nil::blueprint::assignment<ArithmetizationType>> &m_assignments;
+            std::size_t m_threads_amount;
+            analysis_cache m_analysis_cache;
+            /// Frames of evaluate(), states of released frames do not refer to the assigner
+            call_frame_pool<BlueprintFieldType> m_frame_pool;
+            std::unordered_map<ethash::hash256, std::size_t, hash256_hasher, hash256_equal> m_bytecode_start_rows;
         };
 
+        /// Executes the code. If call_handler is set, nested calls are executed by the loop over the stack
+        /// of frames, so the native stack does not grow with the call depth. Otherwise they are executed
+        /// by evmc::Host::call() of the host. Frames are taken from the pool of the assigner by call depth.
         template<typename BlueprintFieldType>
         static evmc::Result evaluate(const evmc_host_interface* host, evmc_host_context* ctx,
                                 evmc_revision rev, const evmc_message* msg, const uint8_t* code_ptr, size_t code_size,
-                                std::shared_ptr<nil::evm_assigner::assigner<BlueprintFieldType>> assigner, const std::string& target_circuit = "") {
+                                std::shared_ptr<nil::evm_assigner::assigner<BlueprintFieldType>> assigner, const std::string& target_circuit = "",
+                                nested_call_handler* call_handler = nullptr) {
             if(zkevm_circuits_map.find(target_circuit) == zkevm_circuits_map.end()) {
                 std::cerr << "Unknown target circuit " << target_circuit << "\n";
                 return evmc::Result{EVMC_FAILURE, msg->gas};
             }
             const auto zkevm_target_circuit = zkevm_circuits_map.find(target_circuit)->second;
 
-            const evmone::bytes_view container{code_ptr, code_size};
-            const auto code_analysis = evmone::baseline::analyze(rev, container);
-            const auto data = code_analysis.eof_header.get_data(container);
-            evmone::ExecutionState<BlueprintFieldType> state(*msg, rev, *host, ctx, container, data, 0, assigner);
+            using instructions = evmone::instr::core::instructions<BlueprintFieldType, true>;
+            auto& frames = assigner->m_frame_pool;
 
-            state.analysis.baseline = &code_analysis;  // Assign code analysis for instruction implementations.
-            const auto code = code_analysis.executable_code;
+            const auto push_frame = [&](const nested_call& call) -> call_frame<BlueprintFieldType>& {
+                // Nested calls of the same contract reuse its analysis and hash
+                auto code_entry = assigner->m_analysis_cache.get(call.rev, call.code);
+                auto& frame = frames.acquire(call, std::move(code_entry), *host, ctx, assigner);
+                frame.state.suspend_calls = call_handler != nullptr;
 
-            // fill assignments for bytecode circuit
-            if (zkevm_target_circuit & zkevm_circuit::BYTECODE) {
-                assigner->handle_bytecode(state.original_code.size(), code.data());
-            }
+                // fill assignments for bytecode circuit
+                if (zkevm_target_circuit & zkevm_circuit::BYTECODE) {
+                    const auto code = frame.code_entry->analysis.executable_code;
+                    if (frame.code_entry->code_hash) {
+                        assigner->handle_bytecode(frame.state.original_code.size(), code.data(), *frame.code_entry->code_hash);
+                    } else {
+                        assigner->handle_bytecode(frame.state.original_code.size(), code.data());
+                    }
+                }
+                return frame;
+            };
+            // Frames of the call chain are taken from the pool by depth, so the chain is not stored
+            const auto root_depth = msg->depth;
+            auto* current = &push_frame(nested_call{*msg, {code_ptr, code_size}, rev, false});
 
-            int64_t gas = msg->gas;
+            while (true) {
+                auto& frame = *current;
+                auto& state = frame.state;
+                const auto& code_analysis = frame.code_entry->analysis;
+                const auto code = code_analysis.executable_code;
+                const auto& cost_table = evmone::baseline::get_baseline_cost_table(state.rev, code_analysis.eof_header.version);
 
-            const auto& cost_table = evmone::baseline::get_baseline_cost_table(state.rev, code_analysis.eof_header.version);
+                BOOST_LOG_TRIVIAL(debug) << "Run evaluate\n";
 
-            BOOST_LOG_TRIVIAL(debug) << "Run evaluate\n";
+                // Revision is the same for the whole frame, the latest one runs without checks of it
+                if (state.rev == evmone::baseline::specialized_revision) {
+                    frame.gas = evmone::baseline::dispatch<true, evmone::baseline::specialized_revision>(
+                        cost_table, state, frame.gas, code.data());
+                } else {
+                    frame.gas = evmone::baseline::dispatch<true>(cost_table, state, frame.gas, code.data());
+                }
 
-            gas = evmone::baseline::dispatch<false>(cost_table, state, msg->gas, code.data());
+                if (state.status == evmone::suspended_status) {
+                    nested_call call;
+                    auto result = call_handler->begin_call(state.suspended_call.msg, call);
+                    if (result) {
+                        frame.gas = instructions::resume_call(state, *result, frame.gas);
+                    } else {
+                        current = &push_frame(call);
+                    }
+                    continue;
+                }
 
-            BOOST_LOG_TRIVIAL(debug) << "Evaluate result = " << state.status << "\n";
+                BOOST_LOG_TRIVIAL(debug) << "Evaluate result = " << state.status << "\n";
 
-            // fill assignments for read/write circuit
-            if (zkevm_target_circuit & zkevm_circuit::RW) {
-                assigner->handle_rw(state.rw_trace);
-            }
+                // fill assignments for read/write circuit
+                if (zkevm_target_circuit & zkevm_circuit::RW) {
+                    assigner->handle_rw(state.rw_trace);
+                }
 
-            const auto gas_left = (state.status == EVMC_SUCCESS || state.status == EVMC_REVERT) ? gas : 0;
-            const auto gas_refund = (state.status == EVMC_SUCCESS) ? state.gas_refund : 0;
+                const auto gas_left = (state.status == EVMC_SUCCESS || state.status == EVMC_REVERT) ? frame.gas : 0;
+                const auto gas_refund = (state.status == EVMC_SUCCESS) ? state.gas_refund : 0;
 
-            assert(state.output_size != 0 || state.output_offset == 0);
-            const auto evmc_result = evmc::make_result(state.status, gas_left, gas_refund,
-                state.output_size != 0 ? &state.memory[state.output_offset] : nullptr, state.output_size);
-            return evmc::Result{evmc_result};
+                assert(state.output_size != 0 || state.output_offset == 0);
+                evmc::Result result{evmc::make_result(state.status, gas_left, gas_refund,
+                    state.output_size != 0 ? &state.memory[state.output_offset] : nullptr, state.output_size)};
+                frame.release();
+                if (frame.call.msg.depth == root_depth) {
+                    return result;
+                }
+
+                call_handler->end_call(frame.call, result);
+                current = &frames[static_cast<std::size_t>(frame.call.msg.depth - 1)];
+                auto& caller = *current;
+                caller.gas = instructions::resume_call(caller.state, result, caller.gas);
+            }
         }
 
     }     // namespace evm_assigner
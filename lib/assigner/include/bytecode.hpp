@@ -15,39 +15,43 @@
 #include <boost/log/expressions.hpp>
 #include <boost/log/trivial.hpp>
 
-#include <nil/crypto3/hash/algorithm/hash.hpp>
-#include <nil/crypto3/hash/keccak.hpp>
 #include <nil/crypto3/random/algebraic_engine.hpp>
 
+#include <ethash/keccak.hpp>
+
+#include <parallel.hpp>
+#include <small_field_values.hpp>
+#include <zkevm_word.hpp>
+
 namespace nil {
     namespace evm_assigner {
 
+        /// Fills bytecode table for the code with known keccak256 hash.
+        /// Returns the row where the code starts.
+        ///
+        /// Rows are filled by chunks in several threads. VALUE_RLC of the chunk is computed
+        /// from zero first, then the RLC of the previous chunks multiplied by the power
+        /// of the challenge is added to it.
         template<typename BlueprintFieldType>
-        void process_bytecode_input(size_t original_code_size, const uint8_t* code,
-                                    nil::blueprint::assignment<crypto3::zk::snark::plonk_constraint_system<BlueprintFieldType>> &bytecode_table) {
+        std::size_t process_bytecode_input(size_t original_code_size, const uint8_t* code, const ethash::hash256& code_hash,
+                                    nil::blueprint::assignment<crypto3::zk::snark::plonk_constraint_system<BlueprintFieldType>> &bytecode_table,
+                                    std::size_t threads_amount = default_threads_amount()) {
             using value_type = typename BlueprintFieldType::value_type;
-            using hash_type = nil::crypto3::hashes::keccak_1600<256>;
 
             BOOST_LOG_TRIVIAL(debug) << "Process bytecode circuit\n";
             BOOST_LOG_TRIVIAL(debug) << "Bytecode size: " << original_code_size << "\n";
             BOOST_LOG_TRIVIAL(debug) << "Bytecode: " << std::endl;
 
-            std::vector<std::uint8_t> bytecode;
             for (size_t i = 0; i < original_code_size; i++) {
-                const auto op = code[i];
-                bytecode.push_back(op);
-                BOOST_LOG_TRIVIAL(debug) << (uint)op << " ";
+                BOOST_LOG_TRIVIAL(debug) << (uint)code[i] << " ";
             }
             BOOST_LOG_TRIVIAL(debug) << "\n";
 
-            std::string hash = nil::crypto3::hash<nil::crypto3::hashes::keccak_1600<256>>(bytecode.begin(), bytecode.end());
-            std::string str_hi = hash.substr(0, hash.size()-32);
-            std::string str_lo = hash.substr(hash.size()-32, 32);
-            value_type hash_hi;
-            value_type hash_lo;
-            for( std::size_t j = 0; j < str_hi.size(); j++ ){hash_hi *=16; hash_hi += str_hi[j] >= '0' && str_hi[j] <= '9'? str_hi[j] - '0' : str_hi[j] - 'a' + 10;}
-            for( std::size_t j = 0; j < str_lo.size(); j++ ){hash_lo *=16; hash_lo += str_lo[j] >= '0' && str_lo[j] <= '9'? str_lo[j] - '0' : str_lo[j] - 'a' + 10;}
-            BOOST_LOG_TRIVIAL(debug) << std::hex <<  "Contract hash = " << hash << " h:" << hash_hi << " l:" << hash_lo << std::dec << "\n";
+            // Halves of the big-endian digest
+            const zkevm_word<BlueprintFieldType> hash_word(code_hash);
+            const value_type hash_hi = hash_word.w_hi();
+            const value_type hash_lo = hash_word.w_lo();
+            BOOST_LOG_TRIVIAL(debug) << std::hex <<  "Contract hash h:" << hash_hi << " l:" << hash_lo << std::dec << "\n";
 
             static constexpr uint32_t TAG = 0;
             static constexpr uint32_t INDEX = 1;
@@ -60,50 +64,109 @@ namespace nil {
             static constexpr uint32_t VALUE_RLC = 8;
             static constexpr uint32_t RLC_CHALLENGE = 9;
 
+            // Chunk of rows filled by one thread
+            constexpr std::size_t MIN_CHUNK_SIZE = 1 << 14;
+
             value_type rlc_challenge = 15;
-            uint32_t cur = 0;
+            // Bytes, tags and flags are 16-bit values
+            const auto& small_values = small_field_values<BlueprintFieldType>();
             // no one another circuit uses witness column VALUE from 1th table
             uint32_t start_row_index = bytecode_table.witness_column_size(VALUE);
-            std::size_t prev_length = 0;
-            value_type prev_vrlc = 0;
-            value_type push_size = 0;
-            for(size_t j = 0; j < original_code_size; j++, cur++){
-                std::uint8_t byte = bytecode[j];
-                bytecode_table.witness(VALUE, start_row_index + cur) = bytecode[j];
-                bytecode_table.witness(HASH_HI, start_row_index + cur) = hash_hi;
-                bytecode_table.witness(HASH_LO, start_row_index + cur) = hash_lo;
-                bytecode_table.witness(RLC_CHALLENGE, start_row_index + cur) =  rlc_challenge;
-                if( j == 0) {
-                    // HEADER
-                    bytecode_table.witness(TAG, start_row_index + cur) =  0;
-                    bytecode_table.witness(INDEX, start_row_index + cur) = 0;
-                    bytecode_table.witness(IS_OPCODE, start_row_index + cur) = 0;
-                    bytecode_table.witness(PUSH_SIZE, start_row_index + cur) = 0;
-                    prev_length = bytecode[j];
-                    bytecode_table.witness(LENGTH_LEFT, start_row_index + cur) = bytecode[j];
-                    prev_vrlc = 0;
-                    bytecode_table.witness(VALUE_RLC, start_row_index + cur) = 0;
-                    push_size = 0;
-                } else {
-                    // BYTE
-                    bytecode_table.witness(TAG, start_row_index + cur) = 1;
-                    bytecode_table.witness(INDEX, start_row_index + cur) =  j-1;
-                    bytecode_table.witness(LENGTH_LEFT, start_row_index + cur) = prev_length - 1;
-                    prev_length = prev_length - 1;
-                    if (push_size == 0) {
-                        bytecode_table.witness(IS_OPCODE, start_row_index + cur) = 1;
-                        if(byte > 0x5f && byte < 0x80) {
-                            push_size = byte - 0x5f;
-                        }
+            if (original_code_size == 0) return start_row_index;
+
+            // Columns are resized on access, so they are resized before being filled from several threads
+            for (uint32_t column = TAG; column <= RLC_CHALLENGE; column++) {
+                bytecode_table.witness(column, start_row_index + original_code_size - 1);
+            }
+
+            // Size of the push data left after the byte, the first byte is the header
+            const auto next_push_size = [](std::uint8_t push_size, std::uint8_t byte) -> std::uint8_t {
+                if (push_size != 0) return push_size - 1;
+                return (byte > 0x5f && byte < 0x80) ? byte - 0x5f : 0;
+            };
+
+            const auto chunks = split_into_chunks(original_code_size, threads_amount, MIN_CHUNK_SIZE);
+            const std::size_t chunks_amount = chunks.size() - 1;
+
+            // Push data state at the beginning of every chunk, it is found serially without field operations
+            std::vector<std::uint8_t> chunk_push_size(chunks_amount, 0);
+            std::size_t max_chunk_size = chunks[1] - chunks[0];
+            for (std::size_t chunk = 1; chunk < chunks_amount; chunk++) {
+                std::uint8_t push_size = chunk_push_size[chunk - 1];
+                for (std::size_t j = std::max<std::size_t>(chunks[chunk - 1], 1); j < chunks[chunk]; j++) {
+                    push_size = next_push_size(push_size, code[j]);
+                }
+                chunk_push_size[chunk] = push_size;
+                max_chunk_size = std::max(max_chunk_size, chunks[chunk + 1] - chunks[chunk]);
+            }
+
+            std::vector<value_type> chunk_rlc(chunks_amount);
+            parallel_for_chunks(chunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+                std::uint8_t push_size = chunk_push_size[chunk];
+                value_type rlc = 0;
+                for(size_t j = begin; j < end; j++){
+                    const std::size_t row = start_row_index + j;
+                    std::uint8_t byte = code[j];
+                    bytecode_table.witness(VALUE, row) = small_values[byte];
+                    bytecode_table.witness(HASH_HI, row) = hash_hi;
+                    bytecode_table.witness(HASH_LO, row) = hash_lo;
+                    bytecode_table.witness(RLC_CHALLENGE, row) =  rlc_challenge;
+                    if( j == 0) {
+                        // HEADER
+                        bytecode_table.witness(TAG, row) = small_values[0];
+                        bytecode_table.witness(INDEX, row) = small_values[0];
+                        bytecode_table.witness(IS_OPCODE, row) = small_values[0];
+                        bytecode_table.witness(PUSH_SIZE, row) = small_values[0];
+                        bytecode_table.witness(LENGTH_LEFT, row) = small_values[byte];
+                        bytecode_table.witness(VALUE_RLC, row) = 0;
                     } else {
-                        bytecode_table.witness(IS_OPCODE, start_row_index + cur) = 0;
-                        push_size--;
+                        // BYTE
+                        bytecode_table.witness(TAG, row) = small_values[1];
+                        bytecode_table.witness(INDEX, row) = (j - 1 < small_field_values_amount) ? small_values[j - 1] : value_type(j - 1);
+                        // Length left wraps around as the header is a single byte
+                        bytecode_table.witness(LENGTH_LEFT, row) = std::size_t(code[0]) - j;
+                        bytecode_table.witness(IS_OPCODE, row) = small_values[push_size == 0];
+                        push_size = next_push_size(push_size, byte);
+                        bytecode_table.witness(PUSH_SIZE, row) = small_values[push_size];
+                        rlc = rlc * rlc_challenge + small_values[byte];
+                        bytecode_table.witness(VALUE_RLC, row) = rlc;
                     }
-                    bytecode_table.witness(PUSH_SIZE, start_row_index + cur) = push_size;
-                    bytecode_table.witness(VALUE_RLC, start_row_index + cur) = prev_vrlc * rlc_challenge + byte;
-                    prev_vrlc = prev_vrlc * rlc_challenge + byte;
                 }
+                chunk_rlc[chunk] = rlc;
+            });
+
+            if (chunks_amount > 1) {
+                std::vector<value_type> challenge_powers(max_chunk_size + 1);
+                challenge_powers[0] = value_type::one();
+                for (std::size_t i = 1; i < challenge_powers.size(); i++) {
+                    challenge_powers[i] = challenge_powers[i - 1] * rlc_challenge;
+                }
+
+                // RLC of all rows before the chunk
+                std::vector<value_type> previous_rlc(chunks_amount, 0);
+                for (std::size_t chunk = 1; chunk < chunks_amount; chunk++) {
+                    previous_rlc[chunk] = chunk_rlc[chunk - 1];
+                    if (chunk > 1) {
+                        previous_rlc[chunk] += previous_rlc[chunk - 1] * challenge_powers[chunks[chunk] - chunks[chunk - 1]];
+                    }
+                }
+
+                parallel_for_chunks(chunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+                    if (chunk == 0) return;
+                    for (size_t j = begin; j < end; j++) {
+                        bytecode_table.witness(VALUE_RLC, start_row_index + j) += previous_rlc[chunk] * challenge_powers[j - begin + 1];
+                    }
+                });
             }
+            return start_row_index;
+        }
+
+        template<typename BlueprintFieldType>
+        std::size_t process_bytecode_input(size_t original_code_size, const uint8_t* code,
+                                           nil::blueprint::assignment<crypto3::zk::snark::plonk_constraint_system<BlueprintFieldType>> &bytecode_table,
+                                           std::size_t threads_amount = default_threads_amount()) {
+            return process_bytecode_input<BlueprintFieldType>(original_code_size, code, ethash::keccak256(code, original_code_size),
+                                                              bytecode_table, threads_amount);
         }
 
     }     // namespace evm_assigner
@@ -0,0 +1,177 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) Nil Foundation and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------//
+
+#ifndef EVM_ASSIGNER_LIB_ASSIGNER_INCLUDE_FLAT_HASH_MAP_HPP_
+#define EVM_ASSIGNER_LIB_ASSIGNER_INCLUDE_FLAT_HASH_MAP_HPP_
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace nil {
+    namespace evm_assigner {
+
+        /// Hasher of fixed size byte keys like evmc::address and evmc::bytes32.
+        /// Every 64-bit word is mixed by multiplication, so small integers and hashes are spread
+        /// over the high bits, which are taken by flat_hash_map.
+        struct bytes_hasher {
+            template<typename Key>
+            std::uint64_t operator()(const Key& key) const {
+                constexpr std::uint64_t multiplier = 0x9e3779b97f4a7c15;
+                constexpr std::size_t size = sizeof(key.bytes);
+                std::uint64_t hash = 0;
+                std::size_t i = 0;
+                for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+                    std::uint64_t word;
+                    std::memcpy(&word, key.bytes + i, sizeof(word));
+                    hash = (hash ^ word) * multiplier;
+                }
+                if constexpr (size % sizeof(std::uint64_t) != 0) {
+                    std::uint64_t word = 0;
+                    std::memcpy(&word, key.bytes + i, size - i);
+                    hash = (hash ^ word) * multiplier;
+                }
+                return hash;
+            }
+        };
+
+        /// Hash map with open addressing and linear probing over a flat array of element indices.
+        /// Elements are stored in insertion order in a deque and never erased, so references to them
+        /// stay valid after insertion, while iterators are invalidated by it.
+        template<typename Key, typename Value, typename Hasher = bytes_hasher>
+        class flat_hash_map {
+        public:
+            using key_type = Key;
+            using mapped_type = Value;
+            using value_type = std::pair<Key, Value>;
+            using iterator = typename std::deque<value_type>::iterator;
+            using const_iterator = typename std::deque<value_type>::const_iterator;
+
+            iterator begin() {
+                return m_entries.begin();
+            }
+
+            iterator end() {
+                return m_entries.end();
+            }
+
+            const_iterator begin() const {
+                return m_entries.begin();
+            }
+
+            const_iterator end() const {
+                return m_entries.end();
+            }
+
+            std::size_t size() const {
+                return m_entries.size();
+            }
+
+            bool empty() const {
+                return m_entries.empty();
+            }
+
+            iterator find(const Key& key) {
+                const auto position = find_position(key);
+                return position < m_slots.size() && m_slots[position] != empty_slot ?
+                           m_entries.begin() + m_slots[position] : end();
+            }
+
+            const_iterator find(const Key& key) const {
+                const auto position = find_position(key);
+                return position < m_slots.size() && m_slots[position] != empty_slot ?
+                           m_entries.begin() + m_slots[position] : end();
+            }
+
+            /// Inserts the default constructed value if the key is absent.
+            /// @return  The element of the key and whether it was inserted
+            std::pair<iterator, bool> try_emplace(const Key& key) {
+                auto position = find_position(key);
+                if (position < m_slots.size() && m_slots[position] != empty_slot) {
+                    return {m_entries.begin() + m_slots[position], false};
+                }
+                if ((m_entries.size() + 1) * max_load_denominator > m_slots.size() * max_load_numerator) {
+                    rehash(m_slots.empty() ? min_capacity : m_slots.size() * 2);
+                    position = find_position(key);
+                }
+                m_slots[position] = static_cast<std::uint32_t>(m_entries.size());
+                m_entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple());
+                return {std::prev(m_entries.end()), true};
+            }
+
+            Value& operator[](const Key& key) {
+                return try_emplace(key).first->second;
+            }
+
+            /// Allocates slots for the number of elements, so the index is not rebuilt on their insertion
+            void reserve(std::size_t size) {
+                std::size_t capacity = min_capacity;
+                while (size * max_load_denominator > capacity * max_load_numerator) {
+                    capacity *= 2;
+                }
+                if (capacity > m_slots.size()) {
+                    rehash(capacity);
+                }
+            }
+
+            void clear() {
+                m_slots.clear();
+                m_entries.clear();
+            }
+
+        private:
+            static constexpr std::uint32_t empty_slot = std::numeric_limits<std::uint32_t>::max();
+            static constexpr std::size_t min_capacity = 8;
+            /// Linear probing sequences stay short up to 3/4 of occupied slots
+            static constexpr std::size_t max_load_numerator = 3;
+            static constexpr std::size_t max_load_denominator = 4;
+
+            /// Returns the slot of the key or the empty slot where it should be inserted,
+            /// the size of slots if there are no slots.
+            std::size_t find_position(const Key& key) const {
+                if (m_slots.empty()) {
+                    return 0;
+                }
+                const std::size_t mask = m_slots.size() - 1;
+                // High bits of the hash are mixed best
+                auto position = static_cast<std::size_t>(Hasher{}(key) >> m_shift);
+                while (m_slots[position] != empty_slot && !(m_entries[m_slots[position]].first == key)) {
+                    position = (position + 1) & mask;
+                }
+                return position;
+            }
+
+            /// Rebuilds the index with the given number of slots, elements are not moved
+            void rehash(std::size_t capacity) {
+                m_slots.assign(capacity, empty_slot);
+                m_shift = 64 - static_cast<unsigned>(std::countr_zero(capacity));
+                const std::size_t mask = capacity - 1;
+                for (std::size_t i = 0; i < m_entries.size(); i++) {
+                    auto position = static_cast<std::size_t>(Hasher{}(m_entries[i].first) >> m_shift);
+                    while (m_slots[position] != empty_slot) {
+                        position = (position + 1) & mask;
+                    }
+                    m_slots[position] = static_cast<std::uint32_t>(i);
+                }
+            }
+
+            /// Indices of the elements, empty_slot for free slots
+            std::vector<std::uint32_t> m_slots;
+            std::deque<value_type> m_entries;
+            unsigned m_shift = 64;
+        };
+    }     // namespace evm_assigner
+}    // namespace nil
+
+#endif    // EVM_ASSIGNER_LIB_ASSIGNER_INCLUDE_FLAT_HASH_MAP_HPP_
@@ -0,0 +1,57 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) Nil Foundation and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------//
+
+#ifndef EVM_ASSIGNER_LIB_ASSIGNER_INCLUDE_PARALLEL_HPP_
+#define EVM_ASSIGNER_LIB_ASSIGNER_INCLUDE_PARALLEL_HPP_
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace nil {
+    namespace evm_assigner {
+
+        /// Number of threads used for filling assignment tables by default
+        inline std::size_t default_threads_amount() {
+            const std::size_t hardware_threads = std::thread::hardware_concurrency();
+            return hardware_threads == 0 ? 1 : hardware_threads;
+        }
+
+        /// Splits [0, size) into at most threads_amount chunks of at least min_chunk_size elements.
+        /// Returns borders of the chunks, i-th chunk is [borders[i], borders[i + 1]).
+        inline std::vector<std::size_t> split_into_chunks(std::size_t size, std::size_t threads_amount,
+                                                          std::size_t min_chunk_size) {
+            const std::size_t max_chunks_amount = size / std::max<std::size_t>(min_chunk_size, 1);
+            const std::size_t chunks_amount = std::max<std::size_t>(1, std::min(threads_amount, max_chunks_amount));
+            std::vector<std::size_t> borders(chunks_amount + 1);
+            for (std::size_t i = 0; i <= chunks_amount; i++) {
+                borders[i] = size * i / chunks_amount;
+            }
+            return borders;
+        }
+
+        /// Calls fn(chunk_index, begin, end) for every chunk, each chunk is processed in its own thread.
+        /// The first chunk is processed in the calling thread, so a single chunk does not start any threads.
+        template<typename Function>
+        void parallel_for_chunks(const std::vector<std::size_t>& borders, Function fn) {
+            const std::size_t chunks_amount = borders.size() - 1;
+            std::vector<std::thread> threads;
+            threads.reserve(chunks_amount - 1);
+            for (std::size_t chunk = 1; chunk < chunks_amount; chunk++) {
+                threads.emplace_back([&fn, &borders, chunk]() {
+                    fn(chunk, borders[chunk], borders[chunk + 1]);
+                });
+            }
+            fn(0, borders[0], borders[1]);
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+    }     // namespace evm_assigner
+}    // namespace nil
+
+#endif    // EVM_ASSIGNER_LIB_ASSIGNER_INCLUDE_PARALLEL_HPP_
@@ -15,6 +15,15 @@
 #include <boost/log/expressions.hpp>
 #include <boost/log/trivial.hpp>
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include <parallel.hpp>
+#include <small_field_values.hpp>
 #include <zkevm_word.hpp>
 
 namespace nil {
@@ -118,9 +127,395 @@ namespace nil {
             return rw_operation<BlueprintFieldType>({PADDING_OP, 0, 0, 0, 0, 0, 0, 0});
         }
 
+        /// Columnar storage of the RW trace.
+        ///
+        /// Operations are kept in separate packed columns, and the wide fields are encoded
+        /// depending on the operation type:
+        /// - stack operations keep the address in 64 bits and only the value as a full word,
+        /// - memory operations keep the address in 64 bits and the value as a single byte,
+        /// - other operations keep address, storage key, value and previous value as full words.
+        /// Full words are stored in the separate pool, row refers to them by index.
         template<typename BlueprintFieldType>
-        void process_rw_operations(std::vector<rw_operation<BlueprintFieldType>>& rw_trace,
-                                    nil::blueprint::assignment<crypto3::zk::snark::plonk_constraint_system<BlueprintFieldType>> &rw_table) {
+        class rw_trace_buffer {
+        public:
+            using word_type = zkevm_word<BlueprintFieldType>;
+
+            std::size_t size() const {
+                return m_op.size();
+            }
+
+            bool empty() const {
+                return m_op.empty();
+            }
+
+            void reserve(std::size_t rows) {
+                m_op.reserve(rows);
+                m_id.reserve(rows);
+                m_rw_id.reserve(rows);
+                m_is_write.reserve(rows);
+                m_address.reserve(rows);
+                m_value.reserve(rows);
+            }
+
+            void clear() {
+                m_op.clear();
+                m_id.clear();
+                m_rw_id.clear();
+                m_is_write.clear();
+                m_address.clear();
+                m_value.clear();
+                m_words.clear();
+            }
+
+            void push_stack(std::size_t id, uint16_t address, std::size_t rw_id, bool is_write, const word_type& value) {
+                assert(id < ( 1 << 28)); // Maximum calls amount(?)
+                assert(address < 1024);
+                push_row(STACK_OP, WORD_LAYOUT, id, address, rw_id, is_write, m_words.size());
+                m_words.push_back(value);
+            }
+
+            void push_memory(std::size_t id, const word_type& address, std::size_t rw_id, bool is_write, const word_type& value) {
+                assert(id < ( 1 << 28)); // Maximum calls amount(?)
+                if (fits_uint64(address) && value < 0x100) {
+                    push_row(MEMORY_OP, BYTE_LAYOUT, id, address.to_uint64(), rw_id, is_write, value.to_uint64());
+                } else {
+                    push_back(memory_operation<BlueprintFieldType>(id, address, rw_id, is_write, value));
+                }
+            }
+
+            void push_back(const rw_operation<BlueprintFieldType>& operation) {
+                const bool narrow = operation.field == 0 && operation.storage_key == 0 &&
+                                    operation.value_prev == 0 && fits_uint64(operation.address);
+                if (narrow && operation.op == STACK_OP) {
+                    push_row(operation.op, WORD_LAYOUT, operation.id, operation.address.to_uint64(),
+                             operation.rw_id, operation.is_write, m_words.size());
+                    m_words.push_back(operation.value);
+                } else if (narrow && operation.op == MEMORY_OP && operation.value < 0x100) {
+                    push_row(operation.op, BYTE_LAYOUT, operation.id, operation.address.to_uint64(),
+                             operation.rw_id, operation.is_write, operation.value.to_uint64());
+                } else {
+                    // Field type is kept in the unused address column
+                    push_row(operation.op, WIDE_LAYOUT, operation.id, operation.field,
+                             operation.rw_id, operation.is_write, m_words.size());
+                    m_words.push_back(operation.address);
+                    m_words.push_back(operation.storage_key);
+                    m_words.push_back(operation.value);
+                    m_words.push_back(operation.value_prev);
+                }
+            }
+
+            std::uint8_t op(std::size_t i) const {
+                return m_op[i] & OP_MASK;
+            }
+
+            std::size_t id(std::size_t i) const {
+                return m_id[i];
+            }
+
+            word_type address(std::size_t i) const {
+                return layout(i) == WIDE_LAYOUT ? m_words[m_value[i]] : word_type(m_address[i]);
+            }
+
+            std::uint8_t field(std::size_t i) const {
+                return layout(i) == WIDE_LAYOUT ? static_cast<std::uint8_t>(m_address[i]) : 0;
+            }
+
+            word_type storage_key(std::size_t i) const {
+                return layout(i) == WIDE_LAYOUT ? m_words[m_value[i] + 1] : word_type();
+            }
+
+            std::size_t rw_id(std::size_t i) const {
+                return m_rw_id[i];
+            }
+
+            bool is_write(std::size_t i) const {
+                return m_is_write[i] != 0;
+            }
+
+            word_type value(std::size_t i) const {
+                switch (layout(i)) {
+                    case WORD_LAYOUT:
+                        return m_words[m_value[i]];
+                    case BYTE_LAYOUT:
+                        return word_type(uint64_t(m_value[i]));
+                    default:
+                        return m_words[m_value[i] + 2];
+                }
+            }
+
+            word_type value_prev(std::size_t i) const {
+                return layout(i) == WIDE_LAYOUT ? m_words[m_value[i] + 3] : word_type();
+            }
+
+            rw_operation<BlueprintFieldType> operator[](std::size_t i) const {
+                return rw_operation<BlueprintFieldType>({op(i), id(i), address(i), field(i), storage_key(i),
+                                                         rw_id(i), is_write(i), value(i), value_prev(i)});
+            }
+
+            /// Narrow rows have zero field type and storage key, and 64-bit address
+            bool narrow(std::size_t i) const {
+                return layout(i) != WIDE_LAYOUT;
+            }
+
+        private:
+            static constexpr std::uint8_t OP_MASK = 0x0f;
+            static constexpr std::uint8_t WORD_LAYOUT = 0x00;
+            static constexpr std::uint8_t BYTE_LAYOUT = 0x10;
+            static constexpr std::uint8_t WIDE_LAYOUT = 0x20;
+
+            static bool fits_uint64(const word_type& w) {
+                return w.to_uint64(1) == 0 && w.to_uint64(2) == 0 && w.to_uint64(3) == 0;
+            }
+
+            std::uint8_t layout(std::size_t i) const {
+                return m_op[i] & ~OP_MASK;
+            }
+
+            void push_row(std::uint8_t op, std::uint8_t layout, std::size_t id, uint64_t address,
+                          std::size_t rw_id, bool is_write, uint64_t value) {
+                assert(op < rw_options_amount);
+                assert(id <= std::numeric_limits<uint32_t>::max());
+                assert(rw_id <= std::numeric_limits<uint32_t>::max());
+                assert(value <= std::numeric_limits<uint32_t>::max());
+                m_op.push_back(op | layout);
+                m_id.push_back(static_cast<uint32_t>(id));
+                m_rw_id.push_back(static_cast<uint32_t>(rw_id));
+                m_is_write.push_back(is_write);
+                m_address.push_back(address);
+                m_value.push_back(static_cast<uint32_t>(value));
+            }
+
+            std::vector<std::uint8_t> m_op;         // op in low 4 bits, layout in high bits
+            std::vector<std::uint32_t> m_id;
+            std::vector<std::uint32_t> m_rw_id;
+            std::vector<std::uint8_t> m_is_write;
+            std::vector<std::uint64_t> m_address;   // address for narrow layouts, field type for wide one
+            std::vector<std::uint32_t> m_value;     // byte value or index in m_words
+            std::vector<word_type> m_words;
+        };
+
+        namespace detail {
+            /// Sort key of the trace row, limbs go from the most significant one
+            template<std::size_t N>
+            struct rw_sort_key {
+                std::array<uint64_t, N> limbs;
+                uint32_t row;
+            };
+
+            /// Stable LSD radix sort by 16-bit digits.
+            /// Digits which are the same for all keys are skipped, so stack and memory
+            /// operations are usually sorted in 2-4 passes.
+            template<std::size_t N>
+            void radix_sort(std::vector<rw_sort_key<N>>& keys) {
+                constexpr std::size_t DIGIT_BITS = 16;
+                constexpr uint64_t DIGIT_MASK = (1 << DIGIT_BITS) - 1;
+                // Counters initialization costs more than comparison sort for small inputs
+                constexpr std::size_t RADIX_SORT_THRESHOLD = 1 << 10;
+
+                if (keys.size() < RADIX_SORT_THRESHOLD) {
+                    std::sort(keys.begin(), keys.end(), [](const rw_sort_key<N>& l, const rw_sort_key<N>& r) {
+                        return l.limbs != r.limbs ? l.limbs < r.limbs : l.row < r.row;
+                    });
+                    return;
+                }
+
+                std::array<uint64_t, N> varying_bits = {};
+                for (const auto& key : keys) {
+                    for (std::size_t l = 0; l < N; l++) {
+                        varying_bits[l] |= key.limbs[l] ^ keys[0].limbs[l];
+                    }
+                }
+
+                std::vector<rw_sort_key<N>> buffer(keys.size());
+                std::vector<uint32_t> offsets(DIGIT_MASK + 1);
+                for (std::size_t l = N; l-- > 0;) {
+                    for (std::size_t shift = 0; shift < 64; shift += DIGIT_BITS) {
+                        if (((varying_bits[l] >> shift) & DIGIT_MASK) == 0) continue;
+
+                        std::fill(offsets.begin(), offsets.end(), 0);
+                        for (const auto& key : keys) {
+                            offsets[(key.limbs[l] >> shift) & DIGIT_MASK]++;
+                        }
+                        uint32_t offset = 0;
+                        for (auto& count : offsets) {
+                            const auto bucket_size = count;
+                            count = offset;
+                            offset += bucket_size;
+                        }
+                        for (const auto& key : keys) {
+                            buffer[offsets[(key.limbs[l] >> shift) & DIGIT_MASK]++] = key;
+                        }
+                        keys.swap(buffer);
+                    }
+                }
+            }
+
+            /// Sorts rows order[begin, end) by keys built with make_limbs(row)
+            template<std::size_t N, typename MakeLimbs>
+            void sort_rows(std::vector<uint32_t>& order, std::size_t begin, std::size_t end, MakeLimbs make_limbs) {
+                std::vector<rw_sort_key<N>> keys;
+                keys.reserve(end - begin);
+                for (std::size_t k = begin; k < end; k++) {
+                    keys.push_back({make_limbs(order[k]), order[k]});
+                }
+                radix_sort(keys);
+                for (std::size_t k = begin; k < end; k++) {
+                    order[k] = keys[k - begin].row;
+                }
+            }
+        }    // namespace detail
+
+        /// Replaces non-zero values with their inverses, zeros are kept.
+        /// Uses one field inversion and 3 multiplications per value.
+        template<typename FieldValueType>
+        void batch_inverse(std::vector<FieldValueType>& values) {
+            std::vector<FieldValueType> products;
+            products.reserve(values.size());
+            FieldValueType product = FieldValueType::one();
+            for (const auto& value : values) {
+                if (value != 0) {
+                    product *= value;
+                }
+                products.push_back(product);
+            }
+
+            FieldValueType inverse = FieldValueType::one() / product;
+            for (std::size_t i = values.size(); i-- > 0;) {
+                if (values[i] == 0) continue;
+                const FieldValueType previous_product = (i == 0) ? FieldValueType::one() : products[i - 1];
+                const FieldValueType value_inverse = inverse * previous_product;
+                inverse *= values[i];
+                values[i] = value_inverse;
+            }
+        }
+
+        namespace detail {
+            /// Sorted columns of the RW table row, four 16-bit columns per limb.
+            /// The first column is kept in the most significant bits of the first limb.
+            using rw_row_key = std::array<uint64_t, 8>;
+
+            inline void set_row_key_column(rw_row_key& key, std::size_t column, uint64_t value) {
+                key[column / 4] |= (value & 0xffff) << (48 - 16 * (column % 4));
+            }
+
+            inline uint64_t row_key_column(const rw_row_key& key, std::size_t column) {
+                return (key[column / 4] >> (48 - 16 * (column % 4))) & 0xffff;
+            }
+
+            /// Packs sorted columns of the RW table row in the order they are compared:
+            /// op, id chunks, address chunks, field, storage key chunks, rw_id chunks
+            template<typename BlueprintFieldType>
+            rw_row_key make_rw_row_key(const rw_trace_buffer<BlueprintFieldType>& rw_trace, uint32_t row) {
+                rw_row_key key = {};
+                const uint64_t id = rw_trace.id(row);
+                const uint64_t rw_id = rw_trace.rw_id(row);
+                set_row_key_column(key, 0, rw_trace.op(row));
+                set_row_key_column(key, 1, id >> 16);
+                set_row_key_column(key, 2, id);
+                const auto address = rw_trace.address(row);
+                for (std::size_t j = 0; j < 10; j++) {
+                    set_row_key_column(key, 3 + j, address.chunk_16(9 - j));
+                }
+                set_row_key_column(key, 13, rw_trace.field(row));
+                if (!rw_trace.narrow(row)) {
+                    const auto storage_key = rw_trace.storage_key(row);
+                    for (std::size_t j = 0; j < 16; j++) {
+                        set_row_key_column(key, 14 + j, storage_key.chunk_16(15 - j));
+                    }
+                }
+                set_row_key_column(key, 30, rw_id >> 16);
+                set_row_key_column(key, 31, rw_id);
+                return key;
+            }
+        }    // namespace detail
+
+        /// Computes index of the first sorted column of the RW table which differs from the previous row
+        /// and the difference of this column for the sorted rows [begin, end), begin > 0.
+        /// Indices are written to diff_indices[i], differences are stored to differences[i - begin].
+        /// Columns are packed from the trace, so the assignment table is not read.
+        template<typename BlueprintFieldType>
+        void rw_diff_indices(const rw_trace_buffer<BlueprintFieldType>& rw_trace, const std::vector<uint32_t>& order,
+                             std::size_t begin, std::size_t end, std::vector<uint8_t>& diff_indices,
+                             std::vector<typename BlueprintFieldType::value_type>& differences) {
+            constexpr std::size_t SORTED_COLUMNS_AMOUNT = 32;
+            const auto& small_values = small_field_values<BlueprintFieldType>();
+
+            differences.clear();
+            if (begin >= end) return;
+            differences.reserve(end - begin);
+
+            auto previous = detail::make_rw_row_key(rw_trace, order[begin - 1]);
+            for (std::size_t i = begin; i < end; i++) {
+                const auto current = detail::make_rw_row_key(rw_trace, order[i]);
+                std::size_t diff_ind = SORTED_COLUMNS_AMOUNT;
+                for (std::size_t l = 0; l < current.size(); l++) {
+                    const uint64_t diff_bits = current[l] ^ previous[l];
+                    if (diff_bits != 0) {
+                        diff_ind = 4 * l + std::countl_zero(diff_bits) / 16;
+                        break;
+                    }
+                }
+                diff_indices[i] = diff_ind;
+                if (diff_ind == SORTED_COLUMNS_AMOUNT) {
+                    differences.push_back(0);
+                } else {
+                    differences.push_back(small_values[detail::row_key_column(current, diff_ind)] -
+                                          small_values[detail::row_key_column(previous, diff_ind)]);
+                }
+                previous = current;
+            }
+        }
+
+        /// Returns order of the trace rows sorted with rw_operation::operator<
+        ///
+        /// Rows are distributed by operation type with counting sort first.
+        /// Then (address, field, storage_key, rw_id) of every operation type is packed into
+        /// 64-bit limbs and sorted with radix sort. If all rows of the operation type
+        /// are narrow, only address and rw_id are packed.
+        template<typename BlueprintFieldType>
+        std::vector<uint32_t> sort_rw_operations(const rw_trace_buffer<BlueprintFieldType>& rw_trace) {
+            std::array<std::size_t, rw_options_amount + 1> bucket_begin = {};
+            for (std::size_t i = 0; i < rw_trace.size(); i++) {
+                bucket_begin[rw_trace.op(i) + 1]++;
+            }
+            std::partial_sum(bucket_begin.begin(), bucket_begin.end(), bucket_begin.begin());
+
+            std::vector<uint32_t> order(rw_trace.size());
+            auto bucket_end = bucket_begin;
+            for (std::size_t i = 0; i < rw_trace.size(); i++) {
+                order[bucket_end[rw_trace.op(i)]++] = static_cast<uint32_t>(i);
+            }
+
+            for (std::size_t op = 0; op < rw_options_amount; op++) {
+                const auto begin = bucket_begin[op];
+                const auto end = bucket_begin[op + 1];
+                if (end - begin < 2) continue;
+
+                const bool narrow = std::all_of(order.begin() + begin, order.begin() + end,
+                                                [&rw_trace](uint32_t row) { return rw_trace.narrow(row); });
+                if (narrow) {
+                    detail::sort_rows<2>(order, begin, end, [&rw_trace](uint32_t row) {
+                        return std::array<uint64_t, 2>{rw_trace.address(row).to_uint64(), rw_trace.rw_id(row)};
+                    });
+                } else {
+                    detail::sort_rows<10>(order, begin, end, [&rw_trace](uint32_t row) {
+                        const auto address = rw_trace.address(row);
+                        const auto storage_key = rw_trace.storage_key(row);
+                        return std::array<uint64_t, 10>{
+                            address.to_uint64(3), address.to_uint64(2), address.to_uint64(1), address.to_uint64(0),
+                            rw_trace.field(row),
+                            storage_key.to_uint64(3), storage_key.to_uint64(2), storage_key.to_uint64(1), storage_key.to_uint64(0),
+                            rw_trace.rw_id(row)};
+                    });
+                }
+            }
+            return order;
+        }
+
+        template<typename BlueprintFieldType>
+        void process_rw_operations(const rw_trace_buffer<BlueprintFieldType>& rw_trace,
+                                    nil::blueprint::assignment<crypto3::zk::snark::plonk_constraint_system<BlueprintFieldType>> &rw_table,
+                                    std::size_t threads_amount = default_threads_amount()) {
             constexpr std::size_t OP = 0;
             constexpr std::size_t ID = 1;
             constexpr std::size_t ADDRESS = 2;
@@ -158,129 +553,173 @@ namespace nil {
             constexpr std::size_t STATE_ROOT_BEFORE_LO = 57;            // Check, where do we need it.
             constexpr std::size_t IS_LAST = 58;
 
-            constexpr std::size_t SORTED_COLUMNS_AMOUNT = 32;
-
             constexpr std::size_t total_witness_amount = 60;
 
+            // Chunk of rows filled by one thread
+            constexpr std::size_t MIN_CHUNK_SIZE = 1 << 14;
+
             uint32_t start_row_index = rw_table.witness_column_size(OP);
 
             BOOST_LOG_TRIVIAL(debug) << "Process RW circuit\n";
             BOOST_LOG_TRIVIAL(debug) << "Start row index: " << start_row_index << "\n";
 
-            std::vector<uint32_t> sorting = {
-                OP,
-                // ID
-                CHUNKS[0], CHUNKS[1],
-                // address
-                CHUNKS[2], CHUNKS[3], CHUNKS[4], CHUNKS[5], CHUNKS[6],
-                CHUNKS[7], CHUNKS[8], CHUNKS[9], CHUNKS[10], CHUNKS[11],
-                // field
-                FIELD_TYPE,
-                // storage_key
-                CHUNKS[12], CHUNKS[13], CHUNKS[14], CHUNKS[15], CHUNKS[16],
-                CHUNKS[17], CHUNKS[18], CHUNKS[19], CHUNKS[20], CHUNKS[21],
-                CHUNKS[22], CHUNKS[23], CHUNKS[24], CHUNKS[25], CHUNKS[26],
-                CHUNKS[27],
-                // rw_id
-                CHUNKS[28], CHUNKS[29]
-            };
             //sort operations
-            std::sort(rw_trace.begin(), rw_trace.end());
-
-            BOOST_LOG_TRIVIAL(debug) << "Num operations = " << rw_trace.size() << "\n";
-            for(uint32_t i = 0; i < rw_trace.size(); i++){
-                BOOST_LOG_TRIVIAL(debug) << rw_trace[i] << "\n";
-                // Lookup columns
-                rw_table.witness(OP, start_row_index + i) = rw_trace[i].op;
-                rw_table.witness(ID, start_row_index + i) = rw_trace[i].id;
-                rw_table.witness(ADDRESS, start_row_index + i) = rw_trace[i].address.to_field_as_address();
-                rw_table.witness(STORAGE_KEY_HI, start_row_index + i) = rw_trace[i].storage_key.w_hi();
-                rw_table.witness(STORAGE_KEY_LO, start_row_index + i) = rw_trace[i].storage_key.w_lo();
-                rw_table.witness(RW_ID, start_row_index + i) = rw_trace[i].rw_id;
-                rw_table.witness(IS_WRITE, start_row_index + i) = rw_trace[i].is_write;
-                rw_table.witness(VALUE_HI, start_row_index + i) = rw_trace[i].value.w_hi();
-                rw_table.witness(VALUE_LO, start_row_index + i) = rw_trace[i].value.w_lo();
-
-                // Op selectors
-                typename BlueprintFieldType::integral_type mask = (1 << OP_SELECTORS_AMOUNT);
-                for( std::size_t j = 0; j < OP_SELECTORS_AMOUNT; j++){
-                    mask >>= 1;
-                    rw_table.witness(OP_SELECTORS[j], start_row_index + i) = (((rw_trace[i].op & mask) == 0) ? 0 : 1);
+            const auto order = sort_rw_operations(rw_trace);
+            const std::size_t rows_amount = rw_trace.size();
+
+            BOOST_LOG_TRIVIAL(debug) << "Num operations = " << rows_amount << "\n";
+            if (rows_amount == 0) return;
+
+            // Columns are resized on access, so they are resized before being filled from several threads.
+            // Columns depending on the previous row are not filled for the first row.
+            std::vector<std::size_t> row_columns = {OP, ID, ADDRESS, STORAGE_KEY_HI, STORAGE_KEY_LO, FIELD_TYPE, RW_ID, IS_WRITE, VALUE_HI, VALUE_LO};
+            row_columns.insert(row_columns.end(), OP_SELECTORS.begin(), OP_SELECTORS.end());
+            row_columns.insert(row_columns.end(), CHUNKS.begin(), CHUNKS.end());
+            for (const auto column : row_columns) {
+                rw_table.witness(column, start_row_index + rows_amount - 1);
+            }
+            if (rows_amount > 1) {
+                std::vector<std::size_t> diff_columns = {VALUE_BEFORE_HI, VALUE_BEFORE_LO, DIFFERENCE, INV_DIFFERENCE};
+                diff_columns.insert(diff_columns.end(), INDICES.begin(), INDICES.end());
+                for (const auto column : diff_columns) {
+                    rw_table.witness(column, start_row_index + rows_amount - 1);
                 }
+            }
 
-                // Fill chunks.
-                // id
-                mask = 0xffff;
-                mask <<= 16;
-                rw_table.witness(CHUNKS[0], start_row_index + i) = (mask & rw_trace[i].id) >> 16;
-                mask >>= 16;
-                rw_table.witness(CHUNKS[1], start_row_index + i) = (mask & rw_trace[i].id);
-
-                // address
-                mask = 0xffff;
-                mask <<= (16 * 9);
-                for( std::size_t j = 0; j < 10; j++){
-                    rw_table.witness(CHUNKS[2+j], start_row_index + i) = (((rw_trace[i].address & mask) >> (16 * (9-j))));
-                    mask >>= 16;
+            const auto chunks = split_into_chunks(rows_amount, threads_amount, MIN_CHUNK_SIZE);
+            // Chunks, selectors and indices are 16-bit values
+            const auto& small_values = small_field_values<BlueprintFieldType>();
+
+            // Columns which depend only on the operation
+            parallel_for_chunks(chunks, [&](std::size_t, std::size_t begin, std::size_t end) {
+                // Words are converted to the field in batches
+                std::vector<zkevm_word<BlueprintFieldType>> addresses, storage_keys, values;
+                addresses.reserve(end - begin);
+                storage_keys.reserve(end - begin);
+                values.reserve(end - begin);
+                for (std::size_t i = begin; i < end; i++) {
+                    addresses.push_back(rw_trace.address(order[i]));
+                    storage_keys.push_back(rw_trace.storage_key(order[i]));
+                    values.push_back(rw_trace.value(order[i]));
                 }
-
-                // storage key
-                mask = 0xffff;
-                mask <<= (16 * 15);
-                for( std::size_t j = 0; j < 16; j++){
-                    rw_table.witness(CHUNKS[12+j], start_row_index + i) = (((rw_trace[i].storage_key & mask) >> (16 * (15-j))));
-                    mask >>= 16;
+                std::vector<typename BlueprintFieldType::value_type> address_fields, storage_key_hi, storage_key_lo, value_hi, value_lo;
+                to_field_as_address(addresses, address_fields);
+                to_field_hi_lo(storage_keys, storage_key_hi, storage_key_lo);
+                to_field_hi_lo(values, value_hi, value_lo);
+
+                for (std::size_t i = begin; i < end; i++) {
+                    const auto row = order[i];
+                    const auto op = rw_trace.op(row);
+                    const auto id = rw_trace.id(row);
+                    const auto rw_id = rw_trace.rw_id(row);
+                    // Lookup columns
+                    rw_table.witness(OP, start_row_index + i) = small_values[op];
+                    rw_table.witness(ID, start_row_index + i) = id;
+                    rw_table.witness(ADDRESS, start_row_index + i) = address_fields[i - begin];
+                    rw_table.witness(STORAGE_KEY_HI, start_row_index + i) = storage_key_hi[i - begin];
+                    rw_table.witness(STORAGE_KEY_LO, start_row_index + i) = storage_key_lo[i - begin];
+                    rw_table.witness(FIELD_TYPE, start_row_index + i) = small_values[rw_trace.field(row)];
+                    rw_table.witness(RW_ID, start_row_index + i) = rw_id;
+                    rw_table.witness(IS_WRITE, start_row_index + i) = small_values[rw_trace.is_write(row)];
+                    rw_table.witness(VALUE_HI, start_row_index + i) = value_hi[i - begin];
+                    rw_table.witness(VALUE_LO, start_row_index + i) = value_lo[i - begin];
+
+                    // Op selectors
+                    for( std::size_t j = 0; j < OP_SELECTORS_AMOUNT; j++){
+                        rw_table.witness(OP_SELECTORS[j], start_row_index + i) = small_values[(op >> (OP_SELECTORS_AMOUNT - 1 - j)) & 1];
+                    }
+
+                    // Fill chunks.
+                    // id
+                    rw_table.witness(CHUNKS[0], start_row_index + i) = small_values[(id >> 16) & 0xffff];
+                    rw_table.witness(CHUNKS[1], start_row_index + i) = small_values[id & 0xffff];
+
+                    // address
+                    for( std::size_t j = 0; j < 10; j++){
+                        rw_table.witness(CHUNKS[2+j], start_row_index + i) = small_values[addresses[i - begin].chunk_16(9-j)];
+                    }
+
+                    // storage key
+                    const auto storage_key_chunks = storage_keys[i - begin].to_chunks_16();
+                    for( std::size_t j = 0; j < 16; j++){
+                        rw_table.witness(CHUNKS[12+j], start_row_index + i) = small_values[storage_key_chunks[15-j]];
+                    }
+
+                    // rw_key
+                    rw_table.witness(CHUNKS[28], start_row_index + i) = small_values[(rw_id >> 16) & 0xffff];
+                    rw_table.witness(CHUNKS[29], start_row_index + i) = small_values[rw_id & 0xffff];
+                }
+            });
+
+            // Sorting indices and advices, they depend on the previous row.
+            // Value before of the rows continuing previous operation is copied from the previous row,
+            // such rows at the beginning of the chunk are filled after all chunks are processed.
+            std::vector<uint8_t> diff_indices(rows_amount, 0);
+            parallel_for_chunks(chunks, [&](std::size_t, std::size_t begin, std::size_t end) {
+                const std::size_t first_row = std::max<std::size_t>(begin, 1);
+                std::vector<typename BlueprintFieldType::value_type> differences;
+                rw_diff_indices(rw_trace, order, first_row, end, diff_indices, differences);
+
+                // Previous values of the rows starting new operation are converted in one batch
+                std::vector<zkevm_word<BlueprintFieldType>> values_before;
+                for (std::size_t i = first_row; i < end; i++) {
+                    if (diff_indices[i] < 30) {
+                        values_before.push_back(rw_trace.value_prev(order[i]));
+                    }
+                }
+                std::vector<typename BlueprintFieldType::value_type> value_before_hi, value_before_lo;
+                to_field_hi_lo(values_before, value_before_hi, value_before_lo);
+
+                bool value_before_known = false;
+                std::size_t value_before_index = 0;
+                for (std::size_t i = first_row; i < end; i++) {
+                    const std::size_t diff_ind = diff_indices[i];
+                    if( diff_ind < 30 ){
+                        rw_table.witness(VALUE_BEFORE_HI, start_row_index + i) = value_before_hi[value_before_index];
+                        rw_table.witness(VALUE_BEFORE_LO, start_row_index + i) = value_before_lo[value_before_index];
+                        value_before_index++;
+                        value_before_known = true;
+                    } else if (value_before_known) {
+                        rw_table.witness(VALUE_BEFORE_HI, start_row_index + i) = rw_table.witness(VALUE_BEFORE_HI, start_row_index + i - 1);
+                        rw_table.witness(VALUE_BEFORE_LO, start_row_index + i) = rw_table.witness(VALUE_BEFORE_LO, start_row_index + i - 1);
+                    }
+
+                    for(std::size_t j = 0; j < INDICES_AMOUNT; j++){
+                        rw_table.witness(INDICES[j], start_row_index + i) = small_values[(diff_ind >> (INDICES_AMOUNT - 1 - j)) & 1];
+                    }
+
+                    rw_table.witness(DIFFERENCE, start_row_index + i) = differences[i - first_row];
                 }
 
-                // rw_key
-                mask = 0xffff;
-                mask <<= 16;
-                rw_table.witness(CHUNKS[28], start_row_index + i) = (mask & rw_trace[i].rw_id) >> 16;
-                mask >>= 16;
-                rw_table.witness(CHUNKS[29], start_row_index + i) = (mask & rw_trace[i].rw_id);
-
-                // fill sorting indices and advices
-                if( i == 0 ) continue;
-                bool neq = true;
-                std::size_t diff_ind = 0;
-                for(; diff_ind < sorting.size(); diff_ind++){
-                    if(
-                        rw_table.witness(sorting[diff_ind], start_row_index+i) !=
-                        rw_table.witness(sorting[diff_ind], start_row_index+i - 1)
-                    ) break;
+                batch_inverse(differences);
+                for (std::size_t i = first_row; i < end; i++) {
+                    rw_table.witness(INV_DIFFERENCE, start_row_index + i) = differences[i - first_row];
                 }
-                if( diff_ind < 30 ){
-                    rw_table.witness(VALUE_BEFORE_HI, start_row_index + i) = rw_trace[i].value_prev.w_hi();
-                    rw_table.witness(VALUE_BEFORE_LO, start_row_index + i) = rw_trace[i].value_prev.w_lo();
-                } else {
+            });
+
+            for (std::size_t chunk = 0; chunk + 1 < chunks.size(); chunk++) {
+                for (std::size_t i = std::max<std::size_t>(chunks[chunk], 1); i < chunks[chunk + 1] && diff_indices[i] >= 30; i++) {
                     rw_table.witness(VALUE_BEFORE_HI, start_row_index + i) = rw_table.witness(VALUE_BEFORE_HI, start_row_index + i - 1);
                     rw_table.witness(VALUE_BEFORE_LO, start_row_index + i) = rw_table.witness(VALUE_BEFORE_LO, start_row_index + i - 1);
                 }
+            }
 
-                mask = (1 << INDICES_AMOUNT);
-                for(std::size_t j = 0; j < INDICES_AMOUNT; j++){
-                    mask >>= 1;
-                    rw_table.witness(INDICES[j], start_row_index + i) = ((mask & diff_ind) == 0? 0: 1);
-                }
-                if( rw_trace[i].op != START_OP && diff_ind < 30){
+            // Sizes of these columns depend on the last row where they are set, so they are filled serially
+            for (std::size_t i = 0; i < rows_amount; i++) {
+                BOOST_LOG_TRIVIAL(debug) << rw_trace[order[i]] << "\n";
+                if( i == 0 ) continue;
+
+                const auto op = rw_trace.op(order[i]);
+                if( op != START_OP && diff_indices[i] < 30){
                     rw_table.witness(IS_LAST, start_row_index + i - 1) = 1;
                 }
-                if( rw_trace[i].op != START_OP && rw_trace[i].op != PADDING_OP && diff_ind < 30){
+                if( op != START_OP && op != PADDING_OP && diff_indices[i] < 30){
                     rw_table.witness(IS_FIRST, start_row_index + i) = 1;
                 }
-
-                rw_table.witness(DIFFERENCE, start_row_index + i) =
-                    rw_table.witness(sorting[diff_ind], start_row_index+i) -
-                    rw_table.witness(sorting[diff_ind], start_row_index+i - 1);
-                BOOST_LOG_TRIVIAL(debug) << "Diff index = " << diff_ind <<
+                BOOST_LOG_TRIVIAL(debug) << "Diff index = " << std::size_t(diff_indices[i]) <<
                     " is_first = " << rw_table.witness(IS_FIRST, start_row_index + i) <<
                     " is_last = " << rw_table.witness(IS_LAST, start_row_index + i) <<
                     "\n";
-
-                if( rw_table.witness(DIFFERENCE, start_row_index + i) == 0)
-                    rw_table.witness(INV_DIFFERENCE, start_row_index + i) = 0;
-                else
-                    rw_table.witness(INV_DIFFERENCE, start_row_index + i) = BlueprintFieldType::value_type::one() / rw_table.witness(DIFFERENCE, start_row_index+i);
             }
         }
 
@@ -0,0 +1,39 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) Nil Foundation and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//---------------------------------------------------------------------------//
+
+#ifndef EVM_ASSIGNER_LIB_ASSIGNER_INCLUDE_SMALL_FIELD_VALUES_HPP_
+#define EVM_ASSIGNER_LIB_ASSIGNER_INCLUDE_SMALL_FIELD_VALUES_HPP_
+
+#include <cstdint>
+#include <vector>
+
+namespace nil {
+    namespace evm_assigner {
+
+        constexpr std::size_t small_field_values_amount = 1 << 16;
+
+        /// Field elements of all 16-bit values, so that chunks and flags are not converted
+        /// to the field one by one. The table is built on the first use and shared by all threads.
+        template<typename BlueprintFieldType>
+        const std::vector<typename BlueprintFieldType::value_type>& small_field_values() {
+            using value_type = typename BlueprintFieldType::value_type;
+            static const std::vector<value_type> values = [] {
+                std::vector<value_type> result;
+                result.reserve(small_field_values_amount);
+                value_type value = value_type::zero();
+                for (std::size_t i = 0; i < small_field_values_amount; i++) {
+                    result.push_back(value);
+                    value += value_type::one();
+                }
+                return result;
+            }();
+            return values;
+        }
+    }     // namespace evm_assigner
+}    // namespace nil
+
+#endif    // EVM_ASSIGNER_LIB_ASSIGNER_INCLUDE_SMALL_FIELD_VALUES_HPP_
@@ -7,11 +7,12 @@
 #include <ethash/keccak.hpp>
 
 #include <algorithm>
-#include <map>
 #include <vector>
 #include <memory>
+#include <optional>
 
 #include <assigner.hpp>
+#include <flat_hash_map.hpp>
 #include <zkevm_word.hpp>
 
 using namespace evmc::literals;
@@ -24,8 +25,8 @@ struct account
 
     evmc::uint256be balance = {};
     std::vector<uint8_t> code;
-    std::map<evmc::bytes32, evmc::bytes32> storage;
-    std::map<evmc::bytes32, evmc::bytes32> transient_storage;
+    nil::evm_assigner::flat_hash_map<evmc::bytes32, evmc::bytes32> storage;
+    nil::evm_assigner::flat_hash_map<evmc::bytes32, evmc::bytes32> transient_storage;
 
     virtual evmc::bytes32 code_hash() const
     {
@@ -37,12 +38,13 @@ struct account
     }
 };
 
-using accounts = std::map<evmc::address, account>;
+/// Accounts are not moved when others are created, frames keep views of their code
+using accounts = nil::evm_assigner::flat_hash_map<evmc::address, account>;
 
 }  // namespace evmc
 
 template<typename BlueprintFieldType>
-class VMHost : public evmc::Host
+class VMHost : public evmc::Host, public nil::evm_assigner::nested_call_handler
 {
 public:
     VMHost() = default;
@@ -150,22 +152,50 @@ public:
     }
 
     evmc::Result call(const evmc_message& msg) noexcept final
+    {
+        nil::evm_assigner::nested_call nested;
+        if (auto res = begin_call(msg, nested))
+        {
+            return std::move(*res);
+        }
+        // Calls made by the nested code are executed on the frame stack of evaluate()
+        evmc::Result res = nil::evm_assigner::evaluate<BlueprintFieldType>(&get_interface(), to_context(),
+                                                                        nested.rev, &nested.msg, nested.code.data(), nested.code.size(), assigner, target_circuit, this);
+        end_call(nested, res);
+        return res;
+    }
+
+    std::optional<evmc::Result> begin_call(const evmc_message& msg, nil::evm_assigner::nested_call& call) final
     {
         switch (msg.kind)
         {
         case EVMC_CALL:
         case EVMC_CALLCODE:
         case EVMC_DELEGATECALL:
-            return handle_call(msg);
+            return handle_call(msg, call);
         case EVMC_CREATE:
         case EVMC_CREATE2:
-            return handle_create(msg);
+            return handle_create(msg, call);
         default:
             // Unexpected opcode
             return evmc::Result{EVMC_INTERNAL_ERROR};
         }
     }
 
+    void end_call(const nil::evm_assigner::nested_call& call, evmc::Result& res) final
+    {
+        if (!call.is_create)
+        {
+            return;
+        }
+        if (res.status_code == EVMC_SUCCESS)
+        {
+            accounts[call.msg.recipient].code =
+                std::vector<uint8_t>(res.output_data, res.output_data + res.output_size);
+        }
+        res.create_address = call.msg.recipient;
+    }
+
     evmc_tx_context get_tx_context() const noexcept final { return tx_context; }
 
     // NOLINTNEXTLINE(bugprone-exception-escape)
@@ -241,7 +271,7 @@ private:
     std::shared_ptr<nil::evm_assigner::assigner<BlueprintFieldType>> assigner;
     std::string target_circuit;
 
-    evmc::Result handle_call(const evmc_message& msg) {
+    std::optional<evmc::Result> handle_call(const evmc_message& msg, nil::evm_assigner::nested_call& call) {
         auto sender_iter = get_account(msg.sender);
         if (sender_iter == accounts.end())
         {
@@ -268,12 +298,11 @@ private:
             return evmc::Result{EVMC_SUCCESS, msg.gas, 0, msg.input_data, msg.input_size};
         }
         // TODO: handle precompiled contracts
-        evmc::Result res = nil::evm_assigner::evaluate<BlueprintFieldType>(&get_interface(), to_context(),
-                                                                        EVMC_LATEST_STABLE_REVISION, &msg, acc.code.data(), acc.code.size(), assigner, target_circuit);
-        return res;
+        call = {msg, {acc.code.data(), acc.code.size()}, EVMC_LATEST_STABLE_REVISION, false};
+        return std::nullopt;
     }
 
-    evmc::Result handle_create(const evmc_message& msg) {
+    std::optional<evmc::Result> handle_create(const evmc_message& msg, nil::evm_assigner::nested_call& call) {
         evmc::address new_contract_address = calculate_address(msg);
         if (get_account(new_contract_address) != accounts.end())
         {
@@ -290,15 +319,9 @@ private:
         init_msg.recipient = new_contract_address;
         init_msg.sender = msg.sender;
         init_msg.input_size = 0;
-        evmc::Result res = nil::evm_assigner::evaluate<BlueprintFieldType>(&get_interface(), to_context(),
-                                                                        EVMC_LATEST_STABLE_REVISION, &init_msg, msg.input_data, msg.input_size, assigner, target_circuit);
-        if (res.status_code == EVMC_SUCCESS)
-        {
-            accounts[new_contract_address].code =
-                std::vector<uint8_t>(res.output_data, res.output_data + res.output_size);
-        }
-        res.create_address = new_contract_address;
-        return res;
+        // The code of the account is stored by end_call()
+        call = {init_msg, {msg.input_data, msg.input_size}, EVMC_LATEST_STABLE_REVISION, true};
+        return std::nullopt;
     }
 
     evmc::address calculate_address(const evmc_message& msg) {
@@ -8,6 +8,10 @@
 #ifndef EVM_ASSIGNER_LIB_ASSIGNER_INCLUDE_ZKEVM_WORD_HPP_
 #define EVM_ASSIGNER_LIB_ASSIGNER_INCLUDE_ZKEVM_WORD_HPP_
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 #include <evmc.hpp>
 #include <intx/intx.hpp>
 #include <ethash/keccak.hpp>
@@ -18,6 +22,8 @@
 #include <nil/marshalling/endianness.hpp>
 #include <nil/crypto3/marshalling/algebra/types/field_element.hpp>
 
+#include <small_field_values.hpp>
+
 namespace nil {
     namespace evm_assigner {
 
@@ -64,12 +70,12 @@ namespace nil {
 
             zkevm_word(const uint8_t* data, size_t len) {
                 assert(len <= 32);
-                // copy data into zero-padded memory
-                std::vector<uint8_t> bytes(32, 0);
+                // copy data into zero-padded buffer, the constructor is used by memory and calldata loads
+                uint8_t bytes[32] = {};
                 for (unsigned i = 0; i < len; ++i) {
                     bytes[32 - len + i] = data[i];
                 }
-                value = intx::be::unsafe::load<intx::uint256>(bytes.data());
+                value = intx::be::unsafe::load<intx::uint256>(bytes);
             }
 
             // operators
@@ -189,6 +195,20 @@ namespace nil {
                 return static_cast<uint64_t>(value[i]);
             }
 
+            /// i-th 16-bit chunk, chunks are numbered from the least significant one
+            uint16_t chunk_16(size_t i) const {
+                return static_cast<uint16_t>(value[i / 4] >> (16 * (i % 4)));
+            }
+
+            /// All 16-bit chunks, the least significant one goes first
+            std::array<uint16_t, 16> to_chunks_16() const {
+                std::array<uint16_t, 16> chunks;
+                for (size_t i = 0; i < chunks.size(); ++i) {
+                    chunks[i] = chunk_16(i);
+                }
+                return chunks;
+            }
+
             const value_type &get_value() const
             {
                 return value;
@@ -275,6 +295,78 @@ namespace nil {
             }
             return os;
         }
+
+        namespace detail {
+            /// Field element of hi * 2^64 + lo, values fitting into 16 bits are taken from the table
+            template<typename BlueprintFieldType>
+            typename BlueprintFieldType::value_type limbs_to_field(
+                    uint64_t hi, uint64_t lo, const std::vector<typename BlueprintFieldType::value_type>& small_values) {
+                if (hi == 0 && lo < small_field_values_amount) {
+                    return small_values[lo];
+                }
+                typename BlueprintFieldType::integral_type res = hi;
+                res = res << 64;
+                res += lo;
+                return res;
+            }
+
+            /// Words are transposed in blocks of this size on the stack
+            constexpr std::size_t limbs_block_size = 64;
+
+            using limbs_block = std::array<std::array<uint64_t, limbs_block_size>, 4>;
+
+            /// Limbs of words[begin, begin + count) in separate arrays, limbs[i][k] is the i-th limb of the (begin + k)-th word
+            template<typename BlueprintFieldType>
+            void transpose_limbs(const std::vector<zkevm_word<BlueprintFieldType>>& words, std::size_t begin,
+                                 std::size_t count, limbs_block& limbs) {
+                for (std::size_t k = 0; k < count; k++) {
+                    for (std::size_t i = 0; i < limbs.size(); i++) {
+                        limbs[i][k] = words[begin + k].to_uint64(i);
+                    }
+                }
+            }
+        }    // namespace detail
+
+        /// Batch version of w_hi() and w_lo(): hi[k] and lo[k] are set to halves of words[k].
+        template<typename BlueprintFieldType>
+        void to_field_hi_lo(const std::vector<zkevm_word<BlueprintFieldType>>& words,
+                            std::vector<typename BlueprintFieldType::value_type>& hi,
+                            std::vector<typename BlueprintFieldType::value_type>& lo) {
+            const auto& small_values = small_field_values<BlueprintFieldType>();
+            hi.resize(words.size());
+            lo.resize(words.size());
+            detail::limbs_block limbs;
+            for (std::size_t begin = 0; begin < words.size(); begin += detail::limbs_block_size) {
+                const std::size_t count = std::min(detail::limbs_block_size, words.size() - begin);
+                detail::transpose_limbs(words, begin, count, limbs);
+                for (std::size_t k = 0; k < count; k++) {
+                    hi[begin + k] = detail::limbs_to_field<BlueprintFieldType>(limbs[3][k], limbs[2][k], small_values);
+                }
+                for (std::size_t k = 0; k < count; k++) {
+                    lo[begin + k] = detail::limbs_to_field<BlueprintFieldType>(limbs[1][k], limbs[0][k], small_values);
+                }
+            }
+        }
+
+        /// Batch version of to_field_as_address(): result[k] is set to the low three limbs (192 bits) of words[k].
+        template<typename BlueprintFieldType>
+        void to_field_as_address(const std::vector<zkevm_word<BlueprintFieldType>>& words,
+                                 std::vector<typename BlueprintFieldType::value_type>& result) {
+            const auto& small_values = small_field_values<BlueprintFieldType>();
+            result.resize(words.size());
+            detail::limbs_block limbs;
+            for (std::size_t begin = 0; begin < words.size(); begin += detail::limbs_block_size) {
+                const std::size_t count = std::min(detail::limbs_block_size, words.size() - begin);
+                detail::transpose_limbs(words, begin, count, limbs);
+                for (std::size_t k = 0; k < count; k++) {
+                    if (limbs[2][k] == 0) {
+                        result[begin + k] = detail::limbs_to_field<BlueprintFieldType>(limbs[1][k], limbs[0][k], small_values);
+                    } else {
+                        result[begin + k] = words[begin + k].to_field_as_address();
+                    }
+                }
+            }
+        }
     }     // namespace evm_assigner
 }    // namespace nil
 #endif    // EVM_ASSIGNER_LIB_ASSIGNER_INCLUDE_ZKEVM_WORD_HPP_
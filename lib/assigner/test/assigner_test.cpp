@@ -1,4 +1,12 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
 #include <map>
+#include <new>
+#include <optional>
+#include <random>
+#include <tuple>
+#include <utility>
 
 #include <assigner.hpp>
 #include <nil/blueprint/blueprint/plonk/assignment.hpp>
@@ -85,6 +93,28 @@ struct evmc_host_context* AssignerTest::ctx;
 evmc_revision AssignerTest::rev = {};
 struct evmc_message AssignerTest::msg;
 
+/// Calls of the global operator new are counted while count_allocations is set
+static bool count_allocations = false;
+static std::size_t allocations_count = 0;
+
+void* operator new(std::size_t size) {
+    if (count_allocations) {
+        ++allocations_count;
+    }
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
 inline void check_eq(const uint8_t* l, const uint8_t* r, size_t len) {
     for (int i = 0; i < len; i++) {
         EXPECT_EQ(l[i], r[i]);
@@ -140,6 +170,55 @@ inline std::string bytes_to_string(const uint8_t *data, int len)
     return res;
 }
 
+using dispatch_fn = int64_t (*)(const evmone::baseline::CostTable&,
+    evmone::ExecutionState<AssignerTest::BlueprintFieldType>&, int64_t, const uint8_t*) noexcept;
+
+/// Gas limits from zero to cover out of gas in every position of short code
+inline std::vector<int64_t> gas_limits_below(int64_t max_gas) {
+    std::vector<int64_t> gas_limits(static_cast<std::size_t>(max_gas));
+    for (int64_t gas = 0; gas < max_gas; gas++) {
+        gas_limits[static_cast<std::size_t>(gas)] = gas;
+    }
+    return gas_limits;
+}
+
+/// Runs the code with the switch loop and with the loop under test for every gas limit,
+/// expects the same status, gas left, RW trace and memory.
+inline void expect_same_execution(const std::vector<uint8_t>& code, const std::vector<int64_t>& gas_limits,
+                                  dispatch_fn dispatch_loop, evmc_revision rev = AssignerTest::rev) {
+    using execution_state = evmone::ExecutionState<AssignerTest::BlueprintFieldType>;
+    const evmone::bytes_view container{code.data(), code.size()};
+    // Only dispatch_decoded uses the decoded instructions
+    const auto code_analysis = evmone::baseline::analyze(rev, container, true);
+    const auto& cost_table = evmone::baseline::get_baseline_cost_table(rev, code_analysis.eof_header.version);
+
+    for (const int64_t gas : gas_limits) {
+        auto expected = std::make_unique<execution_state>(AssignerTest::msg, rev, *AssignerTest::host_interface,
+            AssignerTest::ctx, container, evmone::bytes_view{}, 0, AssignerTest::assigner_ptr);
+        expected->analysis.baseline = &code_analysis;
+        const auto expected_gas = evmone::baseline::dispatch_switch<true>(
+            cost_table, *expected, gas, code_analysis.executable_code.data());
+
+        auto actual = std::make_unique<execution_state>(AssignerTest::msg, rev, *AssignerTest::host_interface,
+            AssignerTest::ctx, container, evmone::bytes_view{}, 0, AssignerTest::assigner_ptr);
+        actual->analysis.baseline = &code_analysis;
+        const auto actual_gas = dispatch_loop(cost_table, *actual, gas, code_analysis.executable_code.data());
+
+        EXPECT_EQ(actual->status, expected->status) << gas;
+        EXPECT_EQ(actual_gas, expected_gas) << gas;
+        ASSERT_EQ(actual->rw_trace.size(), expected->rw_trace.size()) << gas;
+        for (size_t i = 0; i < expected->rw_trace.size(); ++i) {
+            EXPECT_EQ(actual->rw_trace[i].address, expected->rw_trace[i].address) << gas;
+            EXPECT_EQ(actual->rw_trace[i].is_write, expected->rw_trace[i].is_write) << gas;
+            EXPECT_EQ(actual->rw_trace[i].value, expected->rw_trace[i].value) << gas;
+        }
+        ASSERT_EQ(actual->memory.size(), expected->memory.size()) << gas;
+        for (size_t i = 0; i < expected->memory.size(); ++i) {
+            EXPECT_EQ(actual->memory[i], expected->memory[i]) << gas;
+        }
+    }
+}
+
 TEST_F(AssignerTest, conversions_uint256be_to_zkevm_word)
 {
     evmc::uint256be uint256be_number;
@@ -301,6 +380,42 @@ TEST_F(AssignerTest, w_hi_lo)
     EXPECT_EQ(original_numbers.str(), result_numbers.str());
 }
 
+TEST_F(AssignerTest, chunks_16)
+{
+    using intx::operator""_u256;
+    nil::evm_assigner::zkevm_word<BlueprintFieldType> tmp(
+        0x0123456789abcdeffedcba98765432100011223344556677deadbeefcafebabe_u256);
+    const auto chunks = tmp.to_chunks_16();
+    typename BlueprintFieldType::integral_type mask = 0xffff;
+    for (std::size_t i = 0; i < chunks.size(); i++) {
+        EXPECT_EQ(chunks[i], tmp.chunk_16(i));
+        EXPECT_EQ(typename BlueprintFieldType::integral_type(chunks[i]), (tmp & mask) >> (16 * i));
+        mask <<= 16;
+    }
+    EXPECT_EQ(chunks[0], 0xbabe);
+    EXPECT_EQ(chunks[15], 0x0123);
+}
+TEST_F(AssignerTest, batch_field_conversion)
+{
+    using word_type = nil::evm_assigner::zkevm_word<BlueprintFieldType>;
+    std::mt19937_64 rng(5);
+    std::vector<word_type> words = {word_type(0), word_type(1), word_type(65535), word_type(65536)};
+    for (std::size_t i = 0; i < 100; i++) {
+        words.push_back(word_type(intx::uint256{rng(), rng() % 3, rng(), rng() % 2}));
+    }
+    std::vector<typename BlueprintFieldType::value_type> hi, lo, addresses;
+    nil::evm_assigner::to_field_hi_lo(words, hi, lo);
+    nil::evm_assigner::to_field_as_address(words, addresses);
+    ASSERT_EQ(hi.size(), words.size());
+    ASSERT_EQ(lo.size(), words.size());
+    ASSERT_EQ(addresses.size(), words.size());
+    for (std::size_t i = 0; i < words.size(); i++) {
+        EXPECT_EQ(hi[i], words[i].w_hi());
+        EXPECT_EQ(lo[i], words[i].w_lo());
+        EXPECT_EQ(addresses[i], words[i].to_field_as_address());
+    }
+}
+
 TEST_F(AssignerTest, set_val)
 {
     using intx::operator""_u256;
@@ -345,6 +460,842 @@ TEST_F(AssignerTest, mul) {
                      3/*trace size*/, false/*is_write*/, 0/*value_hi*/, 8/*value_lo*/);
 }
 
+TEST_F(AssignerTest, push_trace)
+{
+    using word_type = nil::evm_assigner::zkevm_word<BlueprintFieldType>;
+    // PUSH of any length writes one stack item
+    for (const uint8_t op : {evmone::OP_PUSH1, evmone::OP_PUSH2, evmone::OP_PUSH9, evmone::OP_PUSH31, evmone::OP_PUSH32}) {
+        std::vector<uint8_t> code(std::size_t{op} - evmone::OP_PUSH1 + 2, 0);
+        code.front() = op;
+        code.back() = 0xab;
+        const evmone::bytes_view container{code.data(), code.size()};
+        const auto code_analysis = evmone::baseline::analyze(rev, container);
+        const auto& cost_table = evmone::baseline::get_baseline_cost_table(rev, code_analysis.eof_header.version);
+
+        auto state = std::make_unique<evmone::ExecutionState<BlueprintFieldType>>(
+            msg, rev, *host_interface, ctx, container, evmone::bytes_view{}, 0, assigner_ptr);
+        state->analysis.baseline = &code_analysis;
+        evmone::baseline::dispatch<true>(cost_table, *state, msg.gas, code_analysis.executable_code.data());
+
+        EXPECT_EQ(state->status, EVMC_SUCCESS) << int{op};
+        ASSERT_EQ(state->rw_trace.size(), 1u) << int{op};
+        EXPECT_EQ(state->rw_trace[0].address, word_type(0)) << int{op};
+        EXPECT_TRUE(state->rw_trace[0].is_write) << int{op};
+        EXPECT_EQ(state->rw_trace[0].value, word_type(0xab)) << int{op};
+
+        expect_same_execution(code, {msg.gas}, &evmone::baseline::dispatch_decoded<true>);
+        expect_same_execution(code, {msg.gas}, &evmone::baseline::dispatch_cached_top<true>);
+    }
+}
+
+TEST_F(AssignerTest, dispatch_without_tracing)
+{
+    std::vector<uint8_t> code = {
+        evmone::OP_PUSH1,
+        4,
+        evmone::OP_PUSH1,
+        8,
+        evmone::OP_MUL,
+        evmone::OP_PUSH1,
+        0,
+        evmone::OP_MSTORE,
+        evmone::OP_PUSH1,
+        0,
+        evmone::OP_MLOAD,
+    };
+    const evmone::bytes_view container{code.data(), code.size()};
+    const auto code_analysis = evmone::baseline::analyze(rev, container);
+    const auto& cost_table =
+        evmone::baseline::get_baseline_cost_table(rev, code_analysis.eof_header.version);
+
+    auto traced = std::make_unique<evmone::ExecutionState<BlueprintFieldType>>(
+        msg, rev, *host_interface, ctx, container, evmone::bytes_view{}, 0, assigner_ptr);
+    traced->analysis.baseline = &code_analysis;
+    const auto traced_gas = evmone::baseline::dispatch<true>(
+        cost_table, *traced, msg.gas, code_analysis.executable_code.data());
+
+    auto untraced = std::make_unique<evmone::ExecutionState<BlueprintFieldType>>(
+        msg, rev, *host_interface, ctx, container, evmone::bytes_view{}, 0, assigner_ptr);
+    untraced->analysis.baseline = &code_analysis;
+    const auto untraced_gas = evmone::baseline::dispatch<false>(
+        cost_table, *untraced, msg.gas, code_analysis.executable_code.data());
+
+    EXPECT_EQ(traced->status, EVMC_SUCCESS);
+    EXPECT_EQ(untraced->status, traced->status);
+    EXPECT_EQ(untraced_gas, traced_gas);
+    EXPECT_EQ(untraced->memory[31], 32);
+    EXPECT_FALSE(traced->rw_trace.empty());
+    EXPECT_TRUE(untraced->rw_trace.empty());
+}
+
+TEST_F(AssignerTest, dispatch_without_allocations)
+{
+    const std::vector<uint8_t> code = {
+        evmone::OP_PUSH1, 42, evmone::OP_PUSH1, 0, evmone::OP_MSTORE,
+        evmone::OP_PUSH1, 0, evmone::OP_MLOAD, evmone::OP_POP,
+        evmone::OP_PUSH1, 0, evmone::OP_CALLDATALOAD, evmone::OP_PUSH1, 3, evmone::OP_CALLDATALOAD,
+        evmone::OP_ADD, evmone::OP_POP, evmone::OP_PUSH1, 32, evmone::OP_PUSH1, 0, evmone::OP_KECCAK256,
+        evmone::OP_POP,
+    };
+    const evmone::bytes_view container{code.data(), code.size()};
+    const auto code_analysis = evmone::baseline::analyze(rev, container);
+    const auto& cost_table =
+        evmone::baseline::get_baseline_cost_table(rev, code_analysis.eof_header.version);
+
+    auto state = std::make_unique<evmone::ExecutionState<BlueprintFieldType>>(
+        msg, rev, *host_interface, ctx, container, evmone::bytes_view{}, 0, assigner_ptr);
+    state->analysis.baseline = &code_analysis;
+    // The first run grows the memory and the RW trace, the reused state keeps their capacity
+    evmone::baseline::dispatch<true>(cost_table, *state, msg.gas, code_analysis.executable_code.data());
+    ASSERT_EQ(state->status, EVMC_SUCCESS);
+    const auto trace_size = state->rw_trace.size();
+
+    state->reset(msg, rev, *host_interface, ctx, container, evmone::bytes_view{});
+    allocations_count = 0;
+    count_allocations = true;
+    evmone::baseline::dispatch<true>(cost_table, *state, msg.gas, code_analysis.executable_code.data());
+    count_allocations = false;
+
+    EXPECT_EQ(state->status, EVMC_SUCCESS);
+    EXPECT_EQ(state->rw_trace.size(), trace_size);
+    EXPECT_EQ(allocations_count, 0);
+}
+
+#ifdef EVM_ASSIGNER_HAS_COMPUTED_GOTO
+TEST_F(AssignerTest, dispatch_computed_goto)
+{
+    const std::vector<std::vector<uint8_t>> codes = {
+        // Arithmetic and memory
+        {evmone::OP_PUSH1, 4, evmone::OP_PUSH1, 8, evmone::OP_MUL, evmone::OP_PUSH1, 0,
+         evmone::OP_MSTORE, evmone::OP_PUSH1, 0, evmone::OP_MLOAD},
+        // Loop of 3 iterations
+        {evmone::OP_PUSH1, 3, evmone::OP_JUMPDEST, evmone::OP_PUSH1, 1, evmone::OP_SWAP1,
+         evmone::OP_SUB, evmone::OP_DUP1, evmone::OP_PUSH1, 2, evmone::OP_JUMPI, evmone::OP_POP},
+        // Stack underflow
+        {evmone::OP_PUSH1, 1, evmone::OP_ADD},
+        // Undefined instruction
+        {evmone::OP_PUSH1, 1, 0x0c},
+        // Bad jump destination
+        {evmone::OP_PUSH1, 1, evmone::OP_JUMP},
+        // Out of gas in the infinite loop
+        {evmone::OP_JUMPDEST, evmone::OP_PUSH1, 0, evmone::OP_JUMP},
+    };
+    for (const auto& code : codes)
+        expect_same_execution(code, {msg.gas}, &evmone::baseline::dispatch_computed_goto<true>);
+}
+#endif
+
+TEST_F(AssignerTest, dispatch_specialized_revision)
+{
+    constexpr auto specialized_rev = evmone::baseline::specialized_revision;
+    const std::vector<std::vector<uint8_t>> codes = {
+        // Instructions which costs depend on the revision
+        {evmone::OP_PUSH0, evmone::OP_SLOAD, evmone::OP_PUSH1, 3, evmone::OP_PUSH1, 2, evmone::OP_EXP,
+         evmone::OP_ADDRESS, evmone::OP_BALANCE, evmone::OP_ADDRESS, evmone::OP_EXTCODESIZE},
+        // Instruction undefined in the revision
+        {evmone::OP_PUSH1, 1, evmone::OP_DATASIZE},
+        // Out of gas in the middle
+        {evmone::OP_PUSH1, 0, evmone::OP_SLOAD, evmone::OP_PUSH1, 0, evmone::OP_SLOAD},
+    };
+    // The switch loop of any revision is the reference
+    for (const auto& code : codes)
+        expect_same_execution(code, {3000, msg.gas}, &evmone::baseline::dispatch<true, specialized_rev>, specialized_rev);
+}
+
+TEST_F(AssignerTest, basic_blocks)
+{
+    std::vector<uint8_t> code = {
+        evmone::OP_PUSH1, 1, evmone::OP_PUSH1, 2, evmone::OP_ADD,                // 0
+        evmone::OP_JUMPDEST, evmone::OP_POP, evmone::OP_PUSH1, 0, evmone::OP_DUP1,  // 5
+        evmone::OP_MSTORE,
+        evmone::OP_PUSH1, 15, evmone::OP_JUMP,                                   // 11
+        evmone::OP_INVALID,                                                      // 14
+        evmone::OP_JUMPDEST,                                                     // 15
+    };
+    EXPECT_TRUE(evmone::baseline::analyze(rev, {code.data(), code.size()}, false, false).block_map.empty());
+
+    const auto code_analysis = evmone::baseline::analyze(rev, {code.data(), code.size()}, false, true);
+    const auto& block_map = code_analysis.block_map;
+    ASSERT_EQ(block_map.size(), 5u);
+
+    const std::vector<size_t> starts = {0, 5, 11, 14, 15};
+    for (size_t i = 0; i <= code.size(); ++i)
+        EXPECT_EQ(block_map.is_block_start(i), std::find(starts.begin(), starts.end(), i) != starts.end()) << i;
+
+    // gas cost, instructions, stack required, stack max growth, checked tail
+    const std::vector<std::tuple<int64_t, uint32_t, int32_t, int32_t, bool>> expected = {
+        {9, 3, 0, 2, false},
+        {9, 4, 1, 1, true},
+        {11, 2, 0, 1, false},
+        {0, 0, 0, 0, true},
+        {1, 1, 0, 0, true},
+    };
+    for (size_t i = 0; i < starts.size(); ++i)
+    {
+        const auto& block = block_map[starts[i]];
+        EXPECT_EQ(std::make_tuple(block.gas_cost, block.num_instructions, block.stack_required,
+                      block.stack_max_growth, block.checked_tail),
+            expected[i]) << starts[i];
+    }
+}
+
+TEST_F(AssignerTest, dispatch_blocks)
+{
+    const std::vector<std::vector<uint8_t>> codes = {
+        // Blocks with and without checked tails
+        {evmone::OP_PUSH1, 1, evmone::OP_PUSH1, 2, evmone::OP_ADD, evmone::OP_JUMPDEST, evmone::OP_POP,
+         evmone::OP_PUSH1, 0, evmone::OP_DUP1, evmone::OP_MSTORE, evmone::OP_PUSH1, 15, evmone::OP_JUMP,
+         evmone::OP_INVALID, evmone::OP_JUMPDEST},
+        // Loop of 3 iterations
+        {evmone::OP_PUSH1, 3, evmone::OP_JUMPDEST, evmone::OP_PUSH1, 1, evmone::OP_SWAP1,
+         evmone::OP_SUB, evmone::OP_DUP1, evmone::OP_PUSH1, 2, evmone::OP_JUMPI, evmone::OP_POP},
+        // Stack underflow in the middle of the block
+        {evmone::OP_PUSH1, 1, evmone::OP_PUSH1, 2, evmone::OP_ADD, evmone::OP_ADD, evmone::OP_PUSH1, 1},
+        // Undefined instruction
+        {evmone::OP_PUSH1, 1, 0x0c},
+        // Bad jump destination
+        {evmone::OP_PUSH1, 1, evmone::OP_PUSH1, 4, evmone::OP_JUMP},
+        // GAS observes gas left after the precharged block
+        {evmone::OP_PUSH1, 1, evmone::OP_POP, evmone::OP_GAS, evmone::OP_PUSH1, 0, evmone::OP_MSTORE},
+        // Infinite loop
+        {evmone::OP_JUMPDEST, evmone::OP_PUSH1, 0, evmone::OP_JUMP},
+    };
+    for (const auto& code : codes)
+        expect_same_execution(code, gas_limits_below(120), &evmone::baseline::dispatch_blocks<true>);
+}
+
+TEST_F(AssignerTest, decoded_code)
+{
+    using DecodedInstruction = evmone::baseline::CodeAnalysis::DecodedInstruction;
+    const std::vector<uint8_t> code = {evmone::OP_PUSH1, 6, evmone::OP_JUMP, evmone::OP_PUSH1, 7, evmone::OP_JUMP,
+        evmone::OP_JUMPDEST, evmone::OP_DUP1, evmone::OP_JUMP, evmone::OP_PUSH2, 0xab};
+    const evmone::bytes_view container{code.data(), code.size()};
+
+    EXPECT_TRUE(evmone::baseline::analyze(rev, container, false).decoded.instructions.empty());
+
+    const auto code_analysis = evmone::baseline::analyze(rev, container, true);
+    const auto& decoded = code_analysis.decoded;
+    // Instructions with the offsets in the code and the STOP from the padding
+    const std::vector<std::pair<uint8_t, uint32_t>> expected = {{evmone::OP_PUSH1, 0}, {evmone::OP_JUMP, 2},
+        {evmone::OP_PUSH1, 3}, {evmone::OP_JUMP, 5}, {evmone::OP_JUMPDEST, 6}, {evmone::OP_DUP1, 7},
+        {evmone::OP_JUMP, 8}, {evmone::OP_PUSH2, 9}, {evmone::OP_STOP, 11}};
+    ASSERT_EQ(decoded.instructions.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(decoded.instructions[i].opcode, expected[i].first) << i;
+        EXPECT_EQ(decoded.instructions[i].code_offset, expected[i].second) << i;
+    }
+    // Truncated push data is padded with zeros
+    ASSERT_EQ(decoded.push_values.size(), 3u);
+    EXPECT_EQ(decoded.push_values[decoded.instructions[0].arg], intx::uint256{6});
+    EXPECT_EQ(decoded.push_values[decoded.instructions[7].arg], intx::uint256{0xab00});
+    // Jump to JUMPDEST, jump to the middle of the block and dynamic jump
+    EXPECT_EQ(decoded.instructions[1].arg, 4u);
+    EXPECT_EQ(decoded.instructions[3].arg, DecodedInstruction::bad_target);
+    EXPECT_EQ(decoded.instructions[6].arg, DecodedInstruction::dynamic_target);
+    EXPECT_EQ(decoded.block_instructions, (std::vector<uint32_t>{0, 2, 4, 7}));
+    EXPECT_EQ(decoded.instructions[4].block, 2u);
+    EXPECT_EQ(decoded.instructions[5].block, DecodedInstruction::no_block);
+}
+
+TEST_F(AssignerTest, dispatch_decoded)
+{
+    const std::vector<std::vector<uint8_t>> codes = {
+        // Wide constants
+        {evmone::OP_PUSH32, 0xff, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20,
+         21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, evmone::OP_PUSH9, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+         evmone::OP_ADD, evmone::OP_PUSH1, 0, evmone::OP_MSTORE},
+        // Static jump, loop of 3 iterations with JUMPI
+        {evmone::OP_PUSH1, 4, evmone::OP_JUMP, evmone::OP_INVALID, evmone::OP_JUMPDEST, evmone::OP_PUSH1, 3,
+         evmone::OP_JUMPDEST, evmone::OP_PUSH1, 1, evmone::OP_SWAP1, evmone::OP_SUB, evmone::OP_DUP1,
+         evmone::OP_PUSH1, 7, evmone::OP_JUMPI, evmone::OP_POP},
+        // Dynamic jumps to JUMPDEST and to other instruction
+        {evmone::OP_PUSH1, 5, evmone::OP_DUP1, evmone::OP_JUMP, evmone::OP_INVALID, evmone::OP_JUMPDEST,
+         evmone::OP_PUSH1, 1, evmone::OP_ADD, evmone::OP_JUMP},
+        // Static jump into push data and out of the code
+        {evmone::OP_PUSH1, 0x5b, evmone::OP_PUSH1, 1, evmone::OP_JUMP},
+        {evmone::OP_PUSH2, 0xff, 0xff, evmone::OP_JUMP},
+        // Conditional jump which is not taken followed by dynamic jump
+        {evmone::OP_PUSH1, 8, evmone::OP_PUSH1, 0, evmone::OP_PUSH1, 8, evmone::OP_JUMPI, evmone::OP_JUMP,
+         evmone::OP_JUMPDEST},
+        // Stack underflow, undefined instruction and truncated push
+        {evmone::OP_PUSH1, 1, evmone::OP_ADD},
+        {evmone::OP_PUSH1, 1, 0x0c},
+        {evmone::OP_PUSH1, 1, evmone::OP_PUSH4, 1, 2},
+        // PC and GAS read the position in the code and gas left
+        {evmone::OP_PUSH1, 1, evmone::OP_PC, evmone::OP_GAS, evmone::OP_PUSH1, 0, evmone::OP_MSTORE},
+    };
+    for (const auto& code : codes)
+        expect_same_execution(code, gas_limits_below(120), &evmone::baseline::dispatch_decoded<true>);
+}
+
+TEST_F(AssignerTest, dispatch_cached_top)
+{
+    const std::vector<std::vector<uint8_t>> codes = {
+        // Instructions on the cached item
+        {evmone::OP_PUSH1, 7, evmone::OP_PUSH1, 3, evmone::OP_ADD, evmone::OP_PUSH1, 5, evmone::OP_MUL,
+         evmone::OP_PUSH1, 2, evmone::OP_SUB, evmone::OP_PUSH1, 9, evmone::OP_LT, evmone::OP_PUSH1, 1,
+         evmone::OP_GT, evmone::OP_PUSH1, 0, evmone::OP_EQ, evmone::OP_ISZERO, evmone::OP_NOT, evmone::OP_PUSH1, 0xf0,
+         evmone::OP_AND, evmone::OP_PUSH1, 0x0f, evmone::OP_OR, evmone::OP_PUSH1, 3, evmone::OP_XOR},
+        // DUP and SWAP of the cached and spilled items
+        {evmone::OP_PUSH1, 1, evmone::OP_PUSH1, 2, evmone::OP_PUSH1, 3, evmone::OP_DUP1, evmone::OP_DUP3,
+         evmone::OP_SWAP1, evmone::OP_SWAP4, evmone::OP_DUP5, evmone::OP_SWAP2, evmone::OP_POP, evmone::OP_POP,
+         evmone::OP_POP, evmone::OP_ADD, evmone::OP_ADD},
+        // Other instructions between cached ones
+        {evmone::OP_PUSH32, 0xff, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
+         22, 23, 24, 25, 26, 27, 28, 29, 30, 31, evmone::OP_PUSH1, 0, evmone::OP_MSTORE, evmone::OP_PUSH1, 0,
+         evmone::OP_MLOAD, evmone::OP_DUP1, evmone::OP_DIV, evmone::OP_PUSH1, 2, evmone::OP_EXP, evmone::OP_GAS,
+         evmone::OP_ADD, evmone::OP_POP},
+        // Loop of 3 iterations
+        {evmone::OP_PUSH1, 3, evmone::OP_JUMPDEST, evmone::OP_PUSH1, 1, evmone::OP_SWAP1,
+         evmone::OP_SUB, evmone::OP_DUP1, evmone::OP_PUSH1, 2, evmone::OP_JUMPI, evmone::OP_POP},
+        // Stack underflow of cached and other instructions
+        {evmone::OP_PUSH1, 1, evmone::OP_ADD},
+        {evmone::OP_PUSH1, 1, evmone::OP_POP, evmone::OP_POP},
+        {evmone::OP_PUSH1, 1, evmone::OP_SWAP1},
+        {evmone::OP_PUSH1, 1, evmone::OP_MSTORE},
+    };
+    for (const auto& code : codes)
+        expect_same_execution(code, gas_limits_below(120), &evmone::baseline::dispatch_cached_top<true>);
+}
+
+TEST_F(AssignerTest, nested_call_frames)
+{
+    // Calls itself until the depth limit and returns whether its call succeeded
+    const std::vector<uint8_t> code = {
+        evmone::OP_PUSH1, 0, evmone::OP_PUSH1, 0, evmone::OP_PUSH1, 0, evmone::OP_PUSH1, 0, evmone::OP_PUSH1, 0,
+        evmone::OP_PUSH1, 0, evmone::OP_GAS, evmone::OP_CALL, evmone::OP_PUSH1, 0, evmone::OP_MSTORE,
+        evmone::OP_PUSH1, 32, evmone::OP_PUSH1, 0, evmone::OP_RETURN};
+
+    struct recursive_handler : nil::evm_assigner::nested_call_handler {
+        explicit recursive_handler(const std::vector<uint8_t>& _code) : code(_code) {}
+
+        std::optional<evmc::Result> begin_call(const evmc_message& msg, nil::evm_assigner::nested_call& call) override
+        {
+            ++begun;
+            max_depth = std::max(max_depth, msg.depth);
+            call = {msg, {code.data(), code.size()}, EVMC_LATEST_STABLE_REVISION, false};
+            return std::nullopt;
+        }
+
+        void end_call(const nil::evm_assigner::nested_call& call, evmc::Result& result) override
+        {
+            EXPECT_FALSE(call.is_create);
+            EXPECT_EQ(result.status_code, EVMC_SUCCESS);
+            ++ended;
+        }
+
+        const std::vector<uint8_t>& code;
+        int begun = 0;
+        int ended = 0;
+        int32_t max_depth = 0;
+    } handler(code);
+
+    // Enough gas to keep 1/64 of it at every level of calls
+    auto call_msg = msg;
+    call_msg.gas = 1'000'000'000'000'000;
+    const auto result = nil::evm_assigner::evaluate<BlueprintFieldType>(host_interface, ctx,
+        EVMC_LATEST_STABLE_REVISION, &call_msg, code.data(), code.size(), assigner_ptr, "bytecode", &handler);
+
+    EXPECT_EQ(handler.begun, 1024);
+    EXPECT_EQ(handler.ended, 1024);
+    EXPECT_EQ(handler.max_depth, 1024);
+    EXPECT_EQ(result.status_code, EVMC_SUCCESS);
+    EXPECT_GT(result.gas_left, 0);
+    ASSERT_EQ(result.output_size, 32);
+    EXPECT_EQ(result.output_data[31], 1);
+    EXPECT_EQ(assigner_ptr->m_frame_pool.size(), 1025);
+
+    // Frames of all depths are reused
+    const auto repeated = nil::evm_assigner::evaluate<BlueprintFieldType>(host_interface, ctx,
+        EVMC_LATEST_STABLE_REVISION, &call_msg, code.data(), code.size(), assigner_ptr, "bytecode", &handler);
+    EXPECT_EQ(repeated.status_code, EVMC_SUCCESS);
+    EXPECT_EQ(repeated.gas_left, result.gas_left);
+    EXPECT_EQ(assigner_ptr->m_frame_pool.size(), 1025);
+    assigner_ptr->m_frame_pool.clear();
+}
+
+TEST_F(AssignerTest, call_frame_pool)
+{
+    const std::vector<uint8_t> code = {evmone::OP_PUSH1, 1, evmone::OP_PUSH1, 0, evmone::OP_MSTORE};
+    nil::evm_assigner::nested_call call{msg, {code.data(), code.size()}, rev, false};
+    nil::evm_assigner::call_frame_pool<BlueprintFieldType> pool;
+
+    auto& frame = pool.acquire(call, assigner_ptr->m_analysis_cache.get(rev, call.code), *host_interface, ctx, assigner_ptr);
+    const auto& cost_table = evmone::baseline::get_baseline_cost_table(rev, 0);
+    frame.gas = evmone::baseline::dispatch<true>(
+        cost_table, frame.state, frame.gas, frame.code_entry->analysis.executable_code.data());
+    EXPECT_EQ(frame.state.status, EVMC_SUCCESS);
+    EXPECT_FALSE(frame.state.rw_trace.empty());
+    ASSERT_EQ(frame.state.memory.size(), 32);
+    const auto* memory_data = frame.state.memory.data();
+    frame.release();
+    EXPECT_EQ(frame.state.assigner, nullptr);
+
+    // The frame of the same depth is reused with its memory
+    auto& reused = pool.acquire(call, assigner_ptr->m_analysis_cache.get(rev, call.code), *host_interface, ctx, assigner_ptr);
+    EXPECT_EQ(&reused, &frame);
+    EXPECT_EQ(reused.gas, msg.gas);
+    EXPECT_EQ(reused.state.status, EVMC_SUCCESS);
+    EXPECT_EQ(reused.state.memory.size(), 0);
+    EXPECT_EQ(reused.state.memory.data(), memory_data);
+    EXPECT_TRUE(reused.state.rw_trace.empty());
+    EXPECT_EQ(pool.size(), 1);
+
+    call.msg.depth = 2;
+    const auto& nested = pool.acquire(call, assigner_ptr->m_analysis_cache.get(rev, call.code), *host_interface, ctx, assigner_ptr);
+    EXPECT_NE(&nested, &frame);
+    EXPECT_EQ(pool.size(), 3);
+}
+
+TEST_F(AssignerTest, memory_growth)
+{
+    evmone::Memory memory;
+    EXPECT_EQ(memory.size(), 0);
+    // Written bytes are kept and the extend is zero when the memory is moved
+    for (std::size_t size = 4096; size <= (std::size_t{8} << 20); size *= 2) {
+        ASSERT_TRUE(memory.grow(size));
+        EXPECT_EQ(memory.size(), size);
+        EXPECT_EQ(memory[size - 2], 0) << size;
+        if (size > 4096) {
+            EXPECT_EQ(memory[size / 2 - 1], 1) << size;
+        }
+        memory[size - 1] = 1;
+    }
+
+    // Memory is zero after it is reused
+    memory.clear();
+    ASSERT_TRUE(memory.grow(std::size_t{1} << 20));
+    EXPECT_EQ(memory[4095], 0);
+    EXPECT_EQ(memory[(std::size_t{1} << 20) - 1], 0);
+}
+
+TEST_F(AssignerTest, rw_trace_buffer)
+{
+    using word_type = nil::evm_assigner::zkevm_word<BlueprintFieldType>;
+    using intx::operator""_u256;
+    std::vector<nil::evm_assigner::rw_operation<BlueprintFieldType>> operations = {
+        nil::evm_assigner::stack_operation<BlueprintFieldType>(1, 1023, 0, true, word_type(0x1234_u256 << 200)),
+        nil::evm_assigner::memory_operation<BlueprintFieldType>(1, word_type(42), 1, false, word_type(0xff)),
+        nil::evm_assigner::memory_operation<BlueprintFieldType>(1, word_type(1_u256 << 100), 2, true, word_type(7)),
+        nil::evm_assigner::storage_operation<BlueprintFieldType>(
+            2, word_type(5), word_type(3_u256 << 128), 3, true, word_type(8), word_type(9)),
+        nil::evm_assigner::stack_operation<BlueprintFieldType>(2, 0, 4, false, word_type(0)),
+    };
+    nil::evm_assigner::rw_trace_buffer<BlueprintFieldType> trace;
+    for (const auto& operation : operations) {
+        trace.push_back(operation);
+    }
+
+    ASSERT_EQ(trace.size(), operations.size());
+    for (std::size_t i = 0; i < operations.size(); i++) {
+        const auto operation = trace[i];
+        EXPECT_EQ(operation.op, operations[i].op);
+        EXPECT_EQ(operation.id, operations[i].id);
+        EXPECT_EQ(operation.address, operations[i].address);
+        EXPECT_EQ(operation.field, operations[i].field);
+        EXPECT_EQ(operation.storage_key, operations[i].storage_key);
+        EXPECT_EQ(operation.rw_id, operations[i].rw_id);
+        EXPECT_EQ(operation.is_write, operations[i].is_write);
+        EXPECT_EQ(operation.value, operations[i].value);
+        EXPECT_EQ(operation.value_prev, operations[i].value_prev);
+    }
+
+    auto sorted = operations;
+    std::sort(sorted.begin(), sorted.end());
+    const auto order = nil::evm_assigner::sort_rw_operations(trace);
+    for (std::size_t i = 0; i < sorted.size(); i++) {
+        EXPECT_EQ(trace.rw_id(order[i]), sorted[i].rw_id);
+    }
+}
+
+TEST_F(AssignerTest, sort_rw_operations)
+{
+    using word_type = nil::evm_assigner::zkevm_word<BlueprintFieldType>;
+    std::mt19937_64 rng(42);
+    std::vector<nil::evm_assigner::rw_operation<BlueprintFieldType>> operations;
+    nil::evm_assigner::rw_trace_buffer<BlueprintFieldType> trace;
+    // Enough operations of each type to use radix sort
+    for (std::size_t i = 0; i < 10000; i++) {
+        const bool is_write = rng() & 1;
+        switch (rng() % 3) {
+            case 0:
+                operations.push_back(nil::evm_assigner::stack_operation<BlueprintFieldType>(
+                    0, rng() % 1024, i, is_write, word_type(uint64_t(rng()))));
+                break;
+            case 1:
+                operations.push_back(nil::evm_assigner::memory_operation<BlueprintFieldType>(
+                    0, word_type(uint64_t(rng() % 4096)), i, is_write, word_type(uint64_t(rng() % 256))));
+                break;
+            default:
+                operations.push_back(nil::evm_assigner::storage_operation<BlueprintFieldType>(
+                    0, word_type(uint64_t(rng() % 4)), word_type(uint64_t(rng())), i, is_write,
+                    word_type(uint64_t(rng())), word_type(uint64_t(rng()))));
+                break;
+        }
+        trace.push_back(operations.back());
+    }
+
+    std::sort(operations.begin(), operations.end());
+    const auto order = nil::evm_assigner::sort_rw_operations(trace);
+    ASSERT_EQ(order.size(), operations.size());
+    for (std::size_t i = 0; i < operations.size(); i++) {
+        EXPECT_EQ(trace.rw_id(order[i]), operations[i].rw_id);
+    }
+}
+
+TEST_F(AssignerTest, batch_inverse)
+{
+    using value_type = typename BlueprintFieldType::value_type;
+    std::vector<value_type> values = {3, 0, 1, 12345, 0, value_type(0) - 1, 7};
+    auto inverses = values;
+    nil::evm_assigner::batch_inverse(inverses);
+    for (std::size_t i = 0; i < values.size(); i++) {
+        if (values[i] == 0) {
+            EXPECT_EQ(inverses[i], 0);
+        } else {
+            EXPECT_EQ(inverses[i], value_type::one() / values[i]);
+        }
+    }
+}
+
+TEST_F(AssignerTest, analyze_jumpdests)
+{
+    std::mt19937_64 rng(3);
+    for (std::size_t size : {0, 1, 31, 32, 33, 63, 64, 65, 100, 1000, 24576}) {
+        std::vector<uint8_t> code(size);
+        for (auto& byte : code) {
+            const auto kind = rng() % 10;
+            byte = kind < 3 ? evmone::OP_JUMPDEST : (kind < 5 ? evmone::OP_PUSH1 + rng() % 32 : rng() % 256);
+        }
+        const auto analysis = evmone::baseline::analyze(rev, {code.data(), code.size()});
+        ASSERT_EQ(analysis.jumpdest_map.size(), size);
+        ASSERT_EQ(analysis.executable_code, evmone::bytes_view(code.data(), code.size()));
+        EXPECT_EQ(analysis.executable_code.data()[size], evmone::OP_STOP);
+
+        std::vector<bool> expected(size);
+        for (std::size_t i = 0; i < size; i++) {
+            if (code[i] >= evmone::OP_PUSH1 && code[i] <= evmone::OP_PUSH32) {
+                i += code[i] - evmone::OP_PUSH1 + 1;
+            } else if (code[i] == evmone::OP_JUMPDEST) {
+                expected[i] = true;
+            }
+        }
+        for (std::size_t i = 0; i < size; i++) {
+            EXPECT_EQ(analysis.jumpdest_map[i], expected[i]) << "size " << size << " position " << i;
+        }
+    }
+}
+
+TEST_F(AssignerTest, bytecode_hash)
+{
+    using intx::operator""_u256;
+    const std::vector<uint8_t> code = {evmone::OP_STOP};
+    // keccak256(0x00)
+    const nil::evm_assigner::zkevm_word<BlueprintFieldType> expected_hash(
+        0xbc36789e7a1e281436464229828f817d6612f7b477d66591ff96a9e064bcc98a_u256);
+
+    nil::crypto3::zk::snark::plonk_table_description<BlueprintFieldType> desc(65, 1, 5, 30);
+    nil::blueprint::assignment<ArithmetizationType> bytecode_table(desc);
+    nil::evm_assigner::process_bytecode_input<BlueprintFieldType>(code.size(), code.data(), bytecode_table);
+    EXPECT_EQ(bytecode_table.witness(6, 0), expected_hash.w_hi());
+    EXPECT_EQ(bytecode_table.witness(7, 0), expected_hash.w_lo());
+
+    nil::blueprint::assignment<ArithmetizationType> hashed_table(desc);
+    nil::evm_assigner::process_bytecode_input<BlueprintFieldType>(code.size(), code.data(), expected_hash.to_hash(), hashed_table);
+    for (std::uint32_t column = 0; column < 10; column++) {
+        ASSERT_EQ(hashed_table.witness_column_size(column), bytecode_table.witness_column_size(column));
+        for (std::uint32_t row = 0; row < bytecode_table.witness_column_size(column); row++) {
+            EXPECT_EQ(hashed_table.witness(column, row), bytecode_table.witness(column, row));
+        }
+    }
+}
+
+TEST_F(AssignerTest, bytecode_table_parallel_fill)
+{
+    std::mt19937_64 rng(13);
+    // Header byte makes length left wrap around
+    std::vector<uint8_t> code(70000);
+    for (auto& byte : code) {
+        byte = rng() % 4 == 0 ? evmone::OP_PUSH1 + rng() % 32 : rng() % 256;
+    }
+
+    nil::crypto3::zk::snark::plonk_table_description<BlueprintFieldType> desc(65, 1, 5, 30);
+    nil::blueprint::assignment<ArithmetizationType> serial_table(desc);
+    nil::blueprint::assignment<ArithmetizationType> parallel_table(desc);
+    boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::info);
+    // Previous code makes start row of the table non-zero
+    nil::evm_assigner::process_bytecode_input<BlueprintFieldType>(3, code.data(), serial_table, 1);
+    nil::evm_assigner::process_bytecode_input<BlueprintFieldType>(3, code.data(), parallel_table, 1);
+    EXPECT_EQ(nil::evm_assigner::process_bytecode_input<BlueprintFieldType>(code.size(), code.data(), serial_table, 1), 3);
+    EXPECT_EQ(nil::evm_assigner::process_bytecode_input<BlueprintFieldType>(code.size(), code.data(), parallel_table, 4), 3);
+    boost::log::core::get()->reset_filter();
+
+    for (std::uint32_t column = 0; column < 10; column++) {
+        ASSERT_EQ(parallel_table.witness_column_size(column), serial_table.witness_column_size(column));
+        for (std::uint32_t row = 0; row < serial_table.witness_column_size(column); row++) {
+            ASSERT_EQ(parallel_table.witness(column, row), serial_table.witness(column, row));
+        }
+    }
+
+    // VALUE_RLC recurrence and push data flags
+    std::size_t push_size = 0;
+    for (std::uint32_t j = 1; j < code.size(); j++) {
+        const std::uint32_t row = 3 + j;
+        EXPECT_EQ(serial_table.witness(8, row), serial_table.witness(8, row - 1) * 15 + code[j]);
+        EXPECT_EQ(serial_table.witness(3, row), push_size == 0 ? 1 : 0);
+        if (push_size == 0) {
+            push_size = (code[j] > 0x5f && code[j] < 0x80) ? code[j] - 0x5f : 0;
+        } else {
+            push_size--;
+        }
+        EXPECT_EQ(serial_table.witness(4, row), push_size);
+    }
+}
+
+TEST_F(AssignerTest, bytecode_deduplication)
+{
+    nil::crypto3::zk::snark::plonk_table_description<BlueprintFieldType> desc(65, 1, 5, 30);
+    std::vector<nil::blueprint::assignment<ArithmetizationType>> block_assignments = {
+        nil::blueprint::assignment<ArithmetizationType>(desc), nil::blueprint::assignment<ArithmetizationType>(desc)};
+    nil::evm_assigner::assigner<BlueprintFieldType> block_assigner(block_assignments, 1);
+    const auto& bytecode_table = block_assignments[nil::evm_assigner::assigner<BlueprintFieldType>::BYTECODE_TABLE_INDEX];
+
+    const std::vector<uint8_t> code_a = {evmone::OP_PUSH1, 1, evmone::OP_STOP};
+    const std::vector<uint8_t> code_b = {evmone::OP_JUMPDEST, evmone::OP_STOP};
+    const auto hash_a = ethash::keccak256(code_a.data(), code_a.size());
+    const auto hash_b = ethash::keccak256(code_b.data(), code_b.size());
+
+    block_assigner.handle_bytecode(code_a.size(), code_a.data());
+    block_assigner.handle_bytecode(code_b.size(), code_b.data(), hash_b);
+    block_assigner.handle_bytecode(code_a.size(), code_a.data(), hash_a);
+    EXPECT_EQ(bytecode_table.witness_column_size(2), code_a.size() + code_b.size());
+    EXPECT_EQ(block_assigner.bytecode_start_row(hash_a), 0);
+    EXPECT_EQ(block_assigner.bytecode_start_row(hash_b), code_a.size());
+
+    block_assigner.start_block();
+    EXPECT_FALSE(block_assigner.bytecode_start_row(hash_a).has_value());
+    block_assigner.handle_bytecode(code_a.size(), code_a.data());
+    EXPECT_EQ(block_assigner.bytecode_start_row(hash_a), code_a.size() + code_b.size());
+}
+
+TEST_F(AssignerTest, analysis_cache)
+{
+    const std::vector<uint8_t> code_a = {evmone::OP_PUSH1, 1, evmone::OP_JUMPDEST, evmone::OP_STOP};
+    const std::vector<uint8_t> code_b = {evmone::OP_JUMPDEST, evmone::OP_PUSH1, evmone::OP_JUMPDEST};
+    const evmone::bytes_view view_a{code_a.data(), code_a.size()};
+    const evmone::bytes_view view_b{code_b.data(), code_b.size()};
+
+    nil::evm_assigner::analysis_cache cache(2);
+    const auto analysis_a = cache.get(rev, view_a);
+    EXPECT_EQ(cache.misses(), 1);
+    EXPECT_EQ(cache.get(rev, view_a), analysis_a);
+    EXPECT_EQ(cache.hits(), 1);
+    EXPECT_TRUE(analysis_a->analysis.jumpdest_map[2]);
+    ASSERT_TRUE(analysis_a->code_hash);
+    EXPECT_EQ(nil::evm_assigner::zkevm_word<BlueprintFieldType>(*analysis_a->code_hash),
+              nil::evm_assigner::zkevm_word<BlueprintFieldType>(ethash::keccak256(code_a.data(), code_a.size())));
+
+    // Same code with another revision is analyzed again
+    const auto analysis_a_shanghai = cache.get(EVMC_SHANGHAI, view_a);
+    EXPECT_NE(analysis_a_shanghai, analysis_a);
+    EXPECT_EQ(cache.misses(), 2);
+
+    // The least recently used analysis is evicted, but stays valid for its owners
+    const auto analysis_b = cache.get(rev, view_b);
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_TRUE(analysis_b->analysis.jumpdest_map[0]);
+    EXPECT_FALSE(analysis_b->analysis.jumpdest_map[2]);
+    EXPECT_NE(cache.get(rev, view_a), analysis_a);
+    EXPECT_EQ(cache.misses(), 4);
+    EXPECT_EQ(analysis_a->analysis.executable_code, view_a);
+}
+
+TEST_F(AssignerTest, flat_hash_map)
+{
+    nil::evm_assigner::flat_hash_map<evmc::bytes32, evmc::bytes32> storage;
+    EXPECT_TRUE(storage.empty());
+    EXPECT_EQ(storage.find(evmc::bytes32{1}), storage.end());
+
+    std::map<evmc::bytes32, evmc::bytes32> expected;
+    std::mt19937_64 rng{42};
+    for (std::size_t i = 0; i < 10000; i++) {
+        // Small keys collide in the low bytes, hash must spread them
+        const evmc::bytes32 key{rng() % 4096};
+        const evmc::bytes32 value{rng()};
+        storage[key] = value;
+        expected[key] = value;
+    }
+    EXPECT_EQ(storage.size(), expected.size());
+    for (const auto& [key, value] : expected) {
+        const auto it = storage.find(key);
+        ASSERT_NE(it, storage.end());
+        EXPECT_EQ(it->second, value);
+    }
+    EXPECT_EQ(storage.find(evmc::bytes32{4096}), storage.end());
+    EXPECT_EQ(std::distance(storage.begin(), storage.end()), static_cast<std::ptrdiff_t>(expected.size()));
+
+    const auto [existing, inserted] = storage.try_emplace(expected.begin()->first);
+    EXPECT_FALSE(inserted);
+    EXPECT_EQ(existing->second, expected.begin()->second);
+    const auto [added, added_inserted] = storage.try_emplace(evmc::bytes32{4096});
+    EXPECT_TRUE(added_inserted);
+    EXPECT_EQ(added->second, evmc::bytes32{});
+    EXPECT_EQ(storage.size(), expected.size() + 1);
+
+    // Elements are not moved when the index grows
+    const auto* value = &storage.find(expected.begin()->first)->second;
+    for (std::uint64_t i = 0; i < 10000; i++) {
+        storage[evmc::bytes32{(std::uint64_t{1} << 32) + i}];
+    }
+    EXPECT_EQ(&storage.find(expected.begin()->first)->second, value);
+
+    storage.clear();
+    EXPECT_TRUE(storage.empty());
+    EXPECT_EQ(storage.find(expected.begin()->first), storage.end());
+}
+
+TEST_F(AssignerTest, code_of_suspended_frame)
+{
+    constexpr std::size_t creates_amount = 12;
+    // Creates empty accounts with CREATE2, so the accounts index grows while the frame is suspended,
+    // then returns its own code copied by CODECOPY
+    std::vector<uint8_t> contract_code;
+    for (std::size_t salt = 1; salt <= creates_amount; salt++) {
+        contract_code.insert(contract_code.end(), {evmone::OP_PUSH1, static_cast<uint8_t>(salt), evmone::OP_PUSH1, 0,
+            evmone::OP_PUSH1, 0, evmone::OP_PUSH1, 0, evmone::OP_CREATE2, evmone::OP_POP});
+    }
+    contract_code.insert(contract_code.end(), {evmone::OP_CODESIZE, evmone::OP_PUSH1, 0, evmone::OP_PUSH1, 0,
+        evmone::OP_CODECOPY, evmone::OP_CODESIZE, evmone::OP_PUSH1, 0, evmone::OP_RETURN});
+
+    // Calls the contract and returns its output
+    const evmc::address contract_addr{0xc0de};
+    std::vector<uint8_t> code = {evmone::OP_PUSH1, 0, evmone::OP_PUSH1, 0, evmone::OP_PUSH1, 0, evmone::OP_PUSH1, 0,
+        evmone::OP_PUSH1, 0, evmone::OP_PUSH20};
+    code.insert(code.end(), std::begin(contract_addr.bytes), std::end(contract_addr.bytes));
+    code.insert(code.end(), {evmone::OP_GAS, evmone::OP_CALL, evmone::OP_POP, evmone::OP_RETURNDATASIZE,
+        evmone::OP_PUSH1, 0, evmone::OP_PUSH1, 0, evmone::OP_RETURNDATACOPY, evmone::OP_RETURNDATASIZE,
+        evmone::OP_PUSH1, 0, evmone::OP_RETURN});
+
+    evmc::accounts accounts;
+    accounts[msg.recipient] = {};
+    accounts[contract_addr].code = contract_code;
+    evmc_tx_context tx_context{};
+    VMHost<BlueprintFieldType> host{tx_context, accounts, assigner_ptr};
+
+    auto call_msg = msg;
+    call_msg.gas = 10'000'000;
+    const auto result = nil::evm_assigner::evaluate<BlueprintFieldType>(&host.get_interface(), host.to_context(),
+        EVMC_LATEST_STABLE_REVISION, &call_msg, code.data(), code.size(), assigner_ptr, "bytecode", &host);
+
+    EXPECT_EQ(result.status_code, EVMC_SUCCESS);
+    ASSERT_EQ(result.output_size, contract_code.size());
+    EXPECT_TRUE(std::equal(contract_code.begin(), contract_code.end(), result.output_data));
+    assigner_ptr->m_frame_pool.clear();
+}
+
+TEST_F(AssignerTest, small_field_values)
+{
+    using value_type = typename BlueprintFieldType::value_type;
+    const auto& values = nil::evm_assigner::small_field_values<BlueprintFieldType>();
+    ASSERT_EQ(values.size(), nil::evm_assigner::small_field_values_amount);
+    for (std::size_t i : {0, 1, 2, 255, 256, 4097, 65534, 65535}) {
+        EXPECT_EQ(values[i], value_type(i));
+    }
+    EXPECT_EQ(&values, &nil::evm_assigner::small_field_values<BlueprintFieldType>());
+}
+
+TEST_F(AssignerTest, rw_diff_indices)
+{
+    using word_type = nil::evm_assigner::zkevm_word<BlueprintFieldType>;
+    std::mt19937_64 rng(11);
+    nil::evm_assigner::rw_trace_buffer<BlueprintFieldType> trace;
+    for (std::size_t i = 0; i < 3000; i++) {
+        const bool is_write = rng() & 1;
+        switch (rng() % 3) {
+            case 0:
+                trace.push_stack(rng() % 2, rng() % 16, i, is_write, word_type(uint64_t(rng())));
+                break;
+            case 1:
+                trace.push_memory(rng() % 2, word_type(uint64_t(rng() % 64)), i, is_write, word_type(uint64_t(rng() % 256)));
+                break;
+            default:
+                trace.push_back(nil::evm_assigner::storage_operation<BlueprintFieldType>(
+                    0, word_type(uint64_t(rng() % 2)) << 150, word_type(uint64_t(rng() % 4)) << (rng() % 250), i, is_write,
+                    word_type(uint64_t(rng())), word_type(uint64_t(rng()))));
+                break;
+        }
+    }
+
+    nil::crypto3::zk::snark::plonk_table_description<BlueprintFieldType> desc(65, 1, 5, 30);
+    nil::blueprint::assignment<ArithmetizationType> rw_table(desc);
+    boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::info);
+    nil::evm_assigner::process_rw_operations<BlueprintFieldType>(trace, rw_table, 1);
+    boost::log::core::get()->reset_filter();
+
+    // op, id chunks, address chunks, field, storage key chunks, rw_id chunks
+    std::vector<std::uint32_t> sorting = {0};
+    for (std::uint32_t column = 20; column < 32; column++) sorting.push_back(column);
+    sorting.push_back(5);
+    for (std::uint32_t column = 32; column < 50; column++) sorting.push_back(column);
+
+    const auto order = nil::evm_assigner::sort_rw_operations(trace);
+    std::vector<std::uint8_t> diff_indices(trace.size());
+    std::vector<typename BlueprintFieldType::value_type> differences;
+    nil::evm_assigner::rw_diff_indices(trace, order, 1, trace.size(), diff_indices, differences);
+    ASSERT_EQ(differences.size(), trace.size() - 1);
+    for (std::uint32_t row = 1; row < trace.size(); row++) {
+        std::size_t diff_ind = 0;
+        while (diff_ind < sorting.size() && rw_table.witness(sorting[diff_ind], row) == rw_table.witness(sorting[diff_ind], row - 1)) {
+            diff_ind++;
+        }
+        ASSERT_LT(diff_ind, sorting.size());
+        EXPECT_EQ(diff_indices[row], diff_ind);
+        EXPECT_EQ(differences[row - 1], rw_table.witness(sorting[diff_ind], row) - rw_table.witness(sorting[diff_ind], row - 1));
+        EXPECT_EQ(rw_table.witness(50, row), differences[row - 1]);
+    }
+}
+
+TEST_F(AssignerTest, rw_table_parallel_fill)
+{
+    using word_type = nil::evm_assigner::zkevm_word<BlueprintFieldType>;
+    std::mt19937_64 rng(7);
+    nil::evm_assigner::rw_trace_buffer<BlueprintFieldType> trace;
+    // Few addresses, so that sequences of the same address cross chunk borders
+    for (std::size_t i = 0; i < 40000; i++) {
+        const bool is_write = rng() & 1;
+        switch (rng() % 3) {
+            case 0:
+                trace.push_stack(0, rng() % 16, i, is_write, word_type(uint64_t(rng())));
+                break;
+            case 1:
+                trace.push_memory(0, word_type(uint64_t(rng() % 64)), i, is_write, word_type(uint64_t(rng() % 256)));
+                break;
+            default:
+                trace.push_back(nil::evm_assigner::storage_operation<BlueprintFieldType>(
+                    0, word_type(1), word_type(uint64_t(rng() % 4)), i, is_write,
+                    word_type(uint64_t(rng())), word_type(uint64_t(rng()))));
+                break;
+        }
+    }
+
+    nil::crypto3::zk::snark::plonk_table_description<BlueprintFieldType> desc(65, 1, 5, 30);
+    nil::blueprint::assignment<ArithmetizationType> serial_table(desc);
+    nil::blueprint::assignment<ArithmetizationType> parallel_table(desc);
+
+    boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::info);
+    nil::evm_assigner::process_rw_operations<BlueprintFieldType>(trace, serial_table, 1);
+    nil::evm_assigner::process_rw_operations<BlueprintFieldType>(trace, parallel_table, 4);
+    boost::log::core::get()->reset_filter();
+
+    for (std::uint32_t column = 0; column < 60; column++) {
+        ASSERT_EQ(parallel_table.witness_column_size(column), serial_table.witness_column_size(column));
+        for (std::uint32_t row = 0; row < serial_table.witness_column_size(column); row++) {
+            ASSERT_EQ(parallel_table.witness(column, row), serial_table.witness(column, row));
+        }
+    }
+}
+
 // TODO add check assignment tables
 TEST_F(AssignerTest, DISABLED_callvalue_calldataload)
 {